@@ -4,3 +4,37 @@ meta:
 	ADDON_AUTHOR = bakercp
 	ADDON_TAGS = "json" "serialize" "deserialize"
 	ADDON_URL = http://github.com/bakercp/ofxSerializer
+
+common:
+	# Define OF_SERIALIZER_HAVE_ZSTD and link libzstd to enable Zstandard
+	# compression, e.g.:
+	# ADDON_DEFINES += OF_SERIALIZER_HAVE_ZSTD
+	# ADDON_LDFLAGS += -lzstd
+
+linux64:
+	ADDON_DEFINES = OF_SERIALIZER_HAVE_ZLIB
+	ADDON_LDFLAGS = -lz -lrt
+
+linux:
+	ADDON_DEFINES = OF_SERIALIZER_HAVE_ZLIB
+	ADDON_LDFLAGS = -lz -lrt
+
+linuxarmv6l:
+	ADDON_DEFINES = OF_SERIALIZER_HAVE_ZLIB
+	ADDON_LDFLAGS = -lz -lrt
+
+linuxarmv7l:
+	ADDON_DEFINES = OF_SERIALIZER_HAVE_ZLIB
+	ADDON_LDFLAGS = -lz -lrt
+
+osx:
+	ADDON_DEFINES = OF_SERIALIZER_HAVE_ZLIB
+	ADDON_LDFLAGS = -lz
+
+ios:
+	ADDON_DEFINES = OF_SERIALIZER_HAVE_ZLIB
+	ADDON_LDFLAGS = -lz
+
+msys2:
+	ADDON_DEFINES = OF_SERIALIZER_HAVE_ZLIB
+	ADDON_LDFLAGS = -lz
@@ -0,0 +1,74 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#include "ofxSerializer/Glm.h"
+#include "ofxSerializer/Color.h"
+#include "ofxSerializer/Mesh.h"
+#include "ofxSerializer/Polyline.h"
+#include "ofxSerializer/AppSettings.h"
+#include "ofxSerializer/AsyncFileLoggerChannel.h"
+
+
+// Explicit instantiations of the most commonly used serializers. They are
+// declared extern in their headers so that each translation unit does not
+// instantiate them again.
+
+
+namespace glm
+{
+
+
+template void to_json(nlohmann::json& j, const glm::vec2& v);
+template void from_json(const nlohmann::json& j, glm::vec2& v);
+template void to_json(nlohmann::json& j, const glm::vec3& v);
+template void from_json(const nlohmann::json& j, glm::vec3& v);
+template void to_json(nlohmann::json& j, const glm::vec4& v);
+template void from_json(const nlohmann::json& j, glm::vec4& v);
+
+
+} // namespace glm
+
+
+template void to_json(nlohmann::json& j, const ofColor& p);
+template void from_json(const nlohmann::json& j, ofColor& p);
+template void to_json(nlohmann::json& j, const ofFloatColor& p);
+template void from_json(const nlohmann::json& j, ofFloatColor& p);
+
+
+template void to_json(nlohmann::json& j, const ofMesh& v);
+template void from_json(const nlohmann::json& j, ofMesh& v);
+
+
+template void to_json(nlohmann::json& j, const ofPolyline& v);
+template void from_json(const nlohmann::json& j, ofPolyline& v);
+
+
+namespace ofx {
+namespace Serializer {
+
+
+std::shared_ptr<ofBaseLoggerChannel> MakeAsyncFileLoggerChannel(const nlohmann::json& settings)
+{
+    AsyncFileLoggerChannel::Settings channelSettings;
+    channelSettings.filename = settings.value("filename", channelSettings.filename);
+    channelSettings.append = settings.value("append", channelSettings.append);
+    channelSettings.maxQueuedMessages = settings.value("max_queued_messages", channelSettings.maxQueuedMessages);
+    channelSettings.flushInterval = std::chrono::milliseconds(settings.value("flush_interval", uint64_t(channelSettings.flushInterval.count())));
+    channelSettings.rotationSize = settings.value("rotation_size", channelSettings.rotationSize);
+
+    std::string overflow = settings.value("overflow", "drop");
+
+    if (overflow == "block")
+        channelSettings.overflowPolicy = AsyncFileLoggerChannel::OverflowPolicy::BLOCK;
+    else if (overflow != "drop")
+        ofLogWarning("LoadLoggingSettings") << "Unknown overflow policy: " << overflow << ", using drop.";
+
+    return std::make_shared<AsyncFileLoggerChannel>(channelSettings);
+}
+
+
+} } // namespace ofx::Serializer
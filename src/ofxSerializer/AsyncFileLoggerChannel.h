@@ -0,0 +1,271 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_ASYNC_FILE_LOGGER_CHANNEL_H
+#define OF_SERIALIZER_ASYNC_FILE_LOGGER_CHANNEL_H
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include "ofxSerializer/BoundedQueue.h"
+#include "ofLog.h"
+#include "ofFileUtils.h"
+#include "ofUtils.h"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief A logger channel that writes to a file on a background thread.
+///
+/// Log lines are formatted on the calling thread and handed to a bounded
+/// lock-free queue. A writer thread drains the queue into a buffered file,
+/// flushes it periodically and optionally rotates it when it grows too large.
+class AsyncFileLoggerChannel: public ofBaseLoggerChannel
+{
+public:
+    /// \brief What to do when the queue is full.
+    enum class OverflowPolicy
+    {
+        /// \brief Discard the message and count it.
+        DROP,
+        /// \brief Wait for the writer to make room.
+        BLOCK
+    };
+
+    /// \brief The channel settings.
+    struct Settings
+    {
+        /// \brief The log file path, relative to the data folder.
+        std::string filename = "log.log";
+
+        /// \brief True if an existing log file should be appended.
+        bool append = true;
+
+        /// \brief The maximum number of queued messages, rounded up to a
+        ///        power of two. Messages are not limited in size.
+        std::size_t maxQueuedMessages = 4096;
+
+        /// \brief The maximum time between flushes of the file.
+        std::chrono::milliseconds flushInterval { 1000 };
+
+        /// \brief The file size in bytes that triggers rotation, 0 to disable.
+        uint64_t rotationSize = 0;
+
+        /// \brief The queue overflow policy.
+        OverflowPolicy overflowPolicy = OverflowPolicy::DROP;
+    };
+
+    /// \brief Create and start an asynchronous file logger channel.
+    /// \param settings The channel settings.
+    AsyncFileLoggerChannel(const Settings& settings):
+        _settings(settings),
+        _path(ofToDataPath(settings.filename, true)),
+        _queue(settings.maxQueuedMessages)
+    {
+        _thread = std::thread(&AsyncFileLoggerChannel::_run, this);
+    }
+
+    /// \brief Drain the queue and stop the writer thread.
+    virtual ~AsyncFileLoggerChannel()
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _running = false;
+        }
+
+        _condition.notify_all();
+        _spaceAvailable.notify_all();
+        _thread.join();
+    }
+
+    void log(ofLogLevel level, const std::string& module, const std::string& message) override
+    {
+        std::string line = "[" + ofGetLogLevelName(level, true) + "] ";
+
+        if (!module.empty())
+            line += module + ": ";
+
+        line += message;
+        line += "\n";
+
+        _push(line);
+    }
+
+    void log(ofLogLevel level, const std::string& module, const char* format, ...) override
+    {
+        va_list args;
+        va_start(args, format);
+        log(level, module, format, args);
+        va_end(args);
+    }
+
+    void log(ofLogLevel level, const std::string& module, const char* format, va_list args) override
+    {
+        log(level, module, ofVAArgsToString(format, args));
+    }
+
+    /// \returns the number of messages dropped because the queue was full.
+    uint64_t dropped() const
+    {
+        return _dropped.load();
+    }
+
+    /// \returns the channel settings.
+    const Settings& settings() const
+    {
+        return _settings;
+    }
+
+private:
+    void _push(std::string& line)
+    {
+        while (!_queue.tryPush(line))
+        {
+            // Messages logged while the channel is destroyed are dropped too.
+            if (_settings.overflowPolicy == OverflowPolicy::DROP || !_running)
+            {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                _condition.notify_one();
+                return;
+            }
+
+            // The full queue is checked again under the mutex, and the writer
+            // notifies under the mutex after draining, so no wakeup is lost.
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.notify_one();
+            _spaceAvailable.wait(lock, [this]
+            {
+                return _queue.size() < _queue.capacity() || !_running;
+            });
+        }
+
+        // Wake the writer early when the queue is filling up.
+        if (_queue.size() > _queue.capacity() / 2)
+            _condition.notify_one();
+    }
+
+    void _open(bool append)
+    {
+        _stream.open(_path, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+        _stream.seekp(0, std::ios::end);
+        _size = uint64_t(std::max(std::streamoff(0), std::streamoff(_stream.tellp())));
+
+        if (!_stream.is_open())
+            std::cerr << "AsyncFileLoggerChannel: Unable to open " << _path << std::endl;
+    }
+
+    void _rotate()
+    {
+        _stream.close();
+
+        std::string rotatedPath = _path + ".1";
+        std::remove(rotatedPath.c_str());
+        std::rename(_path.c_str(), rotatedPath.c_str());
+
+        _open(false);
+    }
+
+    void _write(const std::string& line)
+    {
+        if (_settings.rotationSize > 0 && _size + line.size() > _settings.rotationSize && _size > 0)
+            _rotate();
+
+        _stream << line;
+        _size += line.size();
+    }
+
+    void _run()
+    {
+        _open(_settings.append);
+
+        std::string line;
+        uint64_t reportedDropped = 0;
+
+        while (true)
+        {
+            bool running = _running.load();
+
+            while (_queue.tryPop(line))
+                _write(line);
+
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _spaceAvailable.notify_all();
+            }
+
+            uint64_t dropped = _dropped.load(std::memory_order_relaxed);
+
+            if (dropped != reportedDropped)
+            {
+                _write("[" + ofGetLogLevelName(OF_LOG_WARNING, true) + "] AsyncFileLoggerChannel: " + ofToString(dropped - reportedDropped) + " messages dropped.\n");
+                reportedDropped = dropped;
+            }
+
+            _stream.flush();
+
+            if (!running)
+                break;
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait_for(lock, _settings.flushInterval, [this]
+            {
+                return _queue.size() > _queue.capacity() / 2 || !_running;
+            });
+        }
+
+        _stream.close();
+    }
+
+    /// \brief The channel settings.
+    Settings _settings;
+
+    /// \brief The absolute log file path.
+    std::string _path;
+
+    /// \brief Formatted log lines waiting to be written.
+    BoundedQueue<std::string> _queue;
+
+    /// \brief The number of dropped log lines.
+    std::atomic<uint64_t> _dropped { 0 };
+
+    /// \brief True until the channel is destroyed.
+    std::atomic<bool> _running { true };
+
+    /// \brief The log file. Only touched by the writer thread.
+    std::ofstream _stream;
+
+    /// \brief The current log file size. Only touched by the writer thread.
+    uint64_t _size = 0;
+
+    /// \brief Guards waiting on the conditions.
+    std::mutex _mutex;
+
+    /// \brief Wakes the writer thread.
+    std::condition_variable _condition;
+
+    /// \brief Wakes producers blocked on a full queue.
+    std::condition_variable _spaceAvailable;
+
+    std::thread _thread;
+
+};
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_ASYNC_FILE_LOGGER_CHANNEL_H
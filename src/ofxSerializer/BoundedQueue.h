@@ -0,0 +1,145 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_BOUNDED_QUEUE_H
+#define OF_SERIALIZER_BOUNDED_QUEUE_H
+
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief A bounded, lock-free multi-producer / multi-consumer queue.
+///
+/// Based on Dmitry Vyukov's bounded MPMC queue. The capacity is rounded up to
+/// a power of two.
+template<typename T>
+class BoundedQueue
+{
+public:
+    /// \brief Create a queue.
+    /// \param capacity The minimum number of elements the queue can hold.
+    BoundedQueue(std::size_t capacity)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        _mask = size - 1;
+        _cells.reset(new Cell[size]);
+
+        for (std::size_t i = 0; i < size; ++i)
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator = (const BoundedQueue&) = delete;
+
+    /// \brief Try to push a value.
+    /// \param value The value to push. It is moved from only on success.
+    /// \returns false if the queue is full.
+    bool tryPush(T& value)
+    {
+        std::size_t position = _enqueuePosition.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Cell& cell = _cells[position & _mask];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+
+            if (difference == 0)
+            {
+                if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = _enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// \brief Try to pop a value.
+    /// \param value The popped value.
+    /// \returns false if the queue is empty.
+    bool tryPop(T& value)
+    {
+        std::size_t position = _dequeuePosition.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Cell& cell = _cells[position & _mask];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position + 1);
+
+            if (difference == 0)
+            {
+                if (_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    value = std::move(cell.value);
+                    cell.sequence.store(position + _mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = _dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// \returns the approximate number of queued elements.
+    std::size_t size() const
+    {
+        std::size_t enqueued = _enqueuePosition.load(std::memory_order_relaxed);
+        std::size_t dequeued = _dequeuePosition.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    /// \returns the capacity of the queue.
+    std::size_t capacity() const
+    {
+        return _mask + 1;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> _cells;
+    std::size_t _mask = 0;
+    alignas(64) std::atomic<std::size_t> _enqueuePosition { 0 };
+    alignas(64) std::atomic<std::size_t> _dequeuePosition { 0 };
+
+};
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_BOUNDED_QUEUE_H
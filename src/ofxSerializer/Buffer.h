@@ -0,0 +1,406 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_BUFFER_H
+#define OF_SERIALIZER_BUFFER_H
+
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "ofConstants.h"
+#include "ofFileUtils.h"
+#include "ofLog.h"
+
+
+#if !defined(TARGET_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief Encode bytes as base64.
+/// \param data The bytes to encode.
+/// \param size The number of bytes.
+/// \returns the base64 text, with padding.
+inline std::string EncodeBase64(const void* data, std::size_t size)
+{
+    static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    std::string text;
+    text.reserve((size + 2) / 3 * 4);
+
+    for (std::size_t i = 0; i < size; i += 3)
+    {
+        uint32_t group = uint32_t(bytes[i]) << 16;
+
+        if (i + 1 < size) group |= uint32_t(bytes[i + 1]) << 8;
+        if (i + 2 < size) group |= uint32_t(bytes[i + 2]);
+
+        text += alphabet[(group >> 18) & 0x3f];
+        text += alphabet[(group >> 12) & 0x3f];
+        text += i + 1 < size ? alphabet[(group >> 6) & 0x3f] : '=';
+        text += i + 2 < size ? alphabet[group & 0x3f] : '=';
+    }
+
+    return text;
+}
+
+
+/// \brief Decode base64 text.
+/// \param text The base64 text, with or without padding.
+/// \returns the decoded bytes.
+/// \throws std::invalid_argument if the text is not base64.
+inline std::vector<uint8_t> DecodeBase64(const std::string& text)
+{
+    std::vector<uint8_t> bytes;
+    bytes.reserve(text.size() / 4 * 3);
+
+    uint32_t group = 0;
+    int bits = 0;
+    std::size_t end = text.size();
+
+    while (end > 0 && text[end - 1] == '=')
+        --end;
+
+    for (std::size_t i = 0; i < end; ++i)
+    {
+        const char c = text[i];
+        uint32_t value = 0;
+
+        if (c >= 'A' && c <= 'Z') value = uint32_t(c - 'A');
+        else if (c >= 'a' && c <= 'z') value = uint32_t(c - 'a' + 26);
+        else if (c >= '0' && c <= '9') value = uint32_t(c - '0' + 52);
+        else if (c == '+') value = 62;
+        else if (c == '/') value = 63;
+        else throw std::invalid_argument("Invalid base64 character.");
+
+        group = (group << 6) | value;
+        bits += 6;
+
+        if (bits >= 8)
+        {
+            bits -= 8;
+            bytes.push_back(uint8_t(group >> bits));
+        }
+    }
+
+    if (bits >= 6 || text.size() - end > 2)
+        throw std::invalid_argument("Invalid base64 length.");
+
+    return bytes;
+}
+
+
+} } // namespace ofx::Serializer
+
+
+/// \brief Serialize an ofBuffer as a binary value.
+///
+/// Binary values are stored natively by CBOR, MessagePack and BSON. Text JSON
+/// would print them as an array of numbers, so for text output use
+/// ofx::Serializer::AttachmentWriter, which writes large buffers to a sidecar
+/// file and small ones as base64.
+inline void to_json(nlohmann::json& j, const ofBuffer& v)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(v.getData());
+    j = nlohmann::json::binary(std::vector<uint8_t>(bytes, bytes + v.size()));
+}
+
+
+/// \brief Deserialize an ofBuffer.
+///
+/// Accepts a binary value, a { "base64": <text> } object, or the object with
+/// a "bytes" array that a binary value becomes when written as text JSON.
+/// Attachment references must be resolved with
+/// ofx::Serializer::AttachmentReader.
+inline void from_json(const nlohmann::json& j, ofBuffer& v)
+{
+    if (j.is_binary())
+    {
+        const auto& bytes = j.get_binary();
+        v.set(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+    else if (j.is_object() && j.count("base64"))
+    {
+        std::vector<uint8_t> bytes = ofx::Serializer::DecodeBase64(j["base64"].get<std::string>());
+        v.set(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+    else if (j.is_object() && j.count("bytes"))
+    {
+        std::vector<uint8_t> bytes = j["bytes"];
+        v.set(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+    else if (j.is_object() && j.count("attachment"))
+    {
+        throw std::runtime_error("ofBuffer attachments must be read with ofx::Serializer::AttachmentReader.");
+    }
+    else
+    {
+        throw std::invalid_argument("Expected a binary value for ofBuffer.");
+    }
+}
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief Writes binary blobs for text JSON documents.
+///
+/// Buffers at or above the size threshold are appended to the sidecar file
+/// and replaced in the document with a reference of the form
+/// { "attachment": { "offset": <bytes>, "length": <bytes> } }, so a text
+/// JSON parser never touches the bytes. Smaller buffers are stored inline as
+/// { "base64": <text> }. For CBOR, MessagePack and BSON, serialize the
+/// buffer directly instead, as those store binary values natively.
+class AttachmentWriter
+{
+public:
+    /// \brief Create an attachment writer.
+    /// \param filename The sidecar file to write. Any existing file is replaced.
+    /// \param threshold The minimum size in bytes of an out-of-line attachment.
+    AttachmentWriter(const std::string& filename, std::size_t threshold = 4096):
+        _filename(filename),
+        _threshold(threshold),
+        _stream(ofToDataPath(filename, true), std::ios::binary | std::ios::trunc)
+    {
+        if (!_stream)
+            ofLogError("AttachmentWriter") << "Unable to open " << filename;
+    }
+
+    /// \brief Add a buffer.
+    /// \param buffer The buffer to add.
+    /// \returns an inline base64 value or an attachment reference.
+    /// \throws std::runtime_error if the sidecar file cannot be written.
+    nlohmann::json add(const ofBuffer& buffer)
+    {
+        return add(buffer.getData(), buffer.size());
+    }
+
+    /// \brief Add a block of bytes.
+    /// \param data The bytes to add.
+    /// \param size The number of bytes.
+    /// \returns an inline base64 value or an attachment reference.
+    /// \throws std::runtime_error if the sidecar file cannot be written.
+    nlohmann::json add(const void* data, std::size_t size)
+    {
+        if (size < _threshold)
+            return { { "base64", EncodeBase64(data, size) } };
+
+        // Align attachments so mapped views are suitably aligned for any type.
+        static const char padding[Alignment] = { 0 };
+        std::size_t remainder = _offset % Alignment;
+
+        if (remainder != 0)
+        {
+            _stream.write(padding, Alignment - remainder);
+            _offset += Alignment - remainder;
+        }
+
+        nlohmann::json reference;
+        reference["attachment"]["offset"] = _offset;
+        reference["attachment"]["length"] = size;
+
+        _stream.write(static_cast<const char*>(data), std::streamsize(size));
+
+        if (!_stream)
+            throw std::runtime_error("Unable to write an attachment to " + _filename + ".");
+
+        _offset += size;
+
+        return reference;
+    }
+
+    /// \brief Flush the sidecar file.
+    /// \returns true if all attachments were written.
+    bool flush()
+    {
+        _stream.flush();
+
+        if (!_stream)
+        {
+            ofLogError("AttachmentWriter") << "Unable to write " << _filename;
+            return false;
+        }
+
+        return true;
+    }
+
+    enum
+    {
+        /// \brief The alignment of each attachment in the sidecar file.
+        Alignment = 16
+    };
+
+private:
+    /// \brief The sidecar file name.
+    std::string _filename;
+
+    /// \brief The minimum size of an out-of-line attachment.
+    std::size_t _threshold = 4096;
+
+    /// \brief The sidecar file.
+    std::ofstream _stream;
+
+    /// \brief The current sidecar file size.
+    uint64_t _offset = 0;
+
+};
+
+
+/// \brief A read-only view of attachment bytes.
+struct AttachmentView
+{
+    /// \brief The first byte, or nullptr if the view is empty.
+    const char* data = nullptr;
+
+    /// \brief The number of bytes.
+    std::size_t size = 0;
+};
+
+
+/// \brief Reads attachments written by an AttachmentWriter.
+///
+/// The sidecar file is memory-mapped where supported, so views of attachments
+/// do not copy. On other platforms the file is read once into memory.
+class AttachmentReader
+{
+public:
+    /// \brief Open a sidecar file.
+    /// \param filename The sidecar file to read.
+    AttachmentReader(const std::string& filename)
+    {
+        std::string path = ofToDataPath(filename, true);
+
+#if !defined(TARGET_WIN32)
+        int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd >= 0)
+        {
+            struct stat info;
+
+            if (::fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                void* mapped = ::mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+                if (mapped != MAP_FAILED)
+                {
+                    _data = static_cast<const char*>(mapped);
+                    _size = std::size_t(info.st_size);
+                    _mapped = true;
+                }
+            }
+
+            ::close(fd);
+        }
+#endif
+
+        if (!_mapped)
+        {
+            _buffer = ofBufferFromFile(path, true);
+            _data = _buffer.getData();
+            _size = _buffer.size();
+        }
+    }
+
+    AttachmentReader(const AttachmentReader&) = delete;
+    AttachmentReader& operator = (const AttachmentReader&) = delete;
+
+    ~AttachmentReader()
+    {
+#if !defined(TARGET_WIN32)
+        if (_mapped)
+            ::munmap(const_cast<char*>(_data), _size);
+#endif
+    }
+
+    /// \brief Get a view of an attachment or inline binary value without copying.
+    ///
+    /// The view remains valid for the lifetime of the reader and of \p j.
+    /// Base64 values must be decoded with read() instead.
+    ///
+    /// \param j An attachment reference or an inline binary value.
+    /// \returns a view of the bytes.
+    /// \throws std::out_of_range if the reference is outside the sidecar file.
+    AttachmentView view(const nlohmann::json& j) const
+    {
+        AttachmentView result;
+
+        if (j.is_binary())
+        {
+            result.data = reinterpret_cast<const char*>(j.get_binary().data());
+            result.size = j.get_binary().size();
+        }
+        else
+        {
+            const auto& attachment = j.at("attachment");
+            uint64_t offset = attachment.at("offset");
+            uint64_t length = attachment.at("length");
+
+            if (offset > _size || length > _size - offset)
+                throw std::out_of_range("Attachment is outside of the sidecar file.");
+
+            result.data = _data + offset;
+            result.size = std::size_t(length);
+        }
+
+        return result;
+    }
+
+    /// \brief Read an attachment or any value from_json() accepts into a buffer.
+    /// \param j The serialized buffer.
+    /// \param buffer The buffer to fill.
+    void read(const nlohmann::json& j, ofBuffer& buffer) const
+    {
+        if (j.is_object() && j.count("attachment"))
+        {
+            AttachmentView bytes = view(j);
+            buffer.set(bytes.data, bytes.size);
+        }
+        else
+        {
+            ::from_json(j, buffer);
+        }
+    }
+
+    /// \returns the size of the sidecar file in bytes.
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+private:
+    /// \brief The sidecar file contents.
+    const char* _data = nullptr;
+
+    /// \brief The sidecar file size.
+    std::size_t _size = 0;
+
+    /// \brief True if the file is memory-mapped.
+    bool _mapped = false;
+
+    /// \brief The file contents when it could not be mapped.
+    ofBuffer _buffer;
+
+};
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_BUFFER_H
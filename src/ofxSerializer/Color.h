@@ -0,0 +1,43 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_COLOR_H
+#define OF_SERIALIZER_COLOR_H
+
+
+#include "json.hpp"
+#include "ofColor.h"
+
+
+template<typename PixelType>
+void to_json(nlohmann::json& j, const ofColor_<PixelType>& p)
+{
+    j = { { "r", p.r }, { "g", p.g }, { "b", p.b }, { "a", p.a } };
+}
+
+
+template<typename PixelType>
+void from_json(const nlohmann::json& j, ofColor_<PixelType>& p)
+{
+    p.r = j.value("r", ofColor_<PixelType>::limit());
+    p.g = j.value("g", ofColor_<PixelType>::limit());
+    p.b = j.value("b", ofColor_<PixelType>::limit());
+    p.a = j.value("a", ofColor_<PixelType>::limit());
+}
+
+
+#ifndef OF_SERIALIZER_NO_EXTERN_TEMPLATES
+
+extern template void to_json(nlohmann::json& j, const ofColor& p);
+extern template void from_json(const nlohmann::json& j, ofColor& p);
+extern template void to_json(nlohmann::json& j, const ofFloatColor& p);
+extern template void from_json(const nlohmann::json& j, ofFloatColor& p);
+
+#endif
+
+
+#endif // OF_SERIALIZER_COLOR_H
@@ -0,0 +1,782 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_COMPRESSION_H
+#define OF_SERIALIZER_COMPRESSION_H
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(OF_SERIALIZER_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief A stream compression format.
+enum class Compression
+{
+    /// \brief No compression.
+    NONE,
+    /// \brief gzip (deflate) compression. Requires OF_SERIALIZER_HAVE_ZLIB.
+    ZLIB,
+    /// \brief Zstandard compression. Requires OF_SERIALIZER_HAVE_ZSTD.
+    ZSTD
+};
+
+
+/// \brief Settings for compressing a stream.
+struct CompressionSettings
+{
+    CompressionSettings(Compression compression = Compression::NONE,
+                        int level = -1):
+        compression(compression),
+        level(level)
+    {
+    }
+
+    /// \brief The compression format.
+    Compression compression = Compression::NONE;
+
+    /// \brief The compression level, or -1 for the format's default.
+    int level = -1;
+
+    /// \brief The number of threads used to compress, or 1 to compress on the
+    ///        calling thread.
+    ///
+    /// With ZLIB the input is split into blocks of blockSize bytes that are
+    /// compressed in parallel as independent gzip members. With ZSTD this sets
+    /// the number of zstd workers, if libzstd was built with multithreading.
+    std::size_t threads = 1;
+
+    /// \brief The size in bytes of each independently compressed block.
+    std::size_t blockSize = 1 << 20;
+};
+
+
+/// \returns true if \p compression is supported by this build.
+inline bool IsCompressionSupported(Compression compression)
+{
+    switch (compression)
+    {
+        case Compression::NONE:
+            return true;
+        case Compression::ZLIB:
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+            return true;
+#else
+            return false;
+#endif
+        case Compression::ZSTD:
+#if defined(OF_SERIALIZER_HAVE_ZSTD)
+            return true;
+#else
+            return false;
+#endif
+    }
+
+    return false;
+}
+
+
+/// \brief Detect a compression format from the first bytes of a stream.
+/// \param data The first bytes of the stream.
+/// \param size The number of bytes, at least 4 for reliable detection.
+/// \returns the detected compression, or Compression::NONE.
+inline Compression DetectCompression(const char* data, std::size_t size)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+
+    if (size >= 4 && bytes[0] == 0x28 && bytes[1] == 0xB5 && bytes[2] == 0x2F && bytes[3] == 0xFD)
+        return Compression::ZSTD;
+
+    // Only gzip is detected. A raw zlib header is too weak a signature, and
+    // matches the first bytes of some uncompressed CBOR, MessagePack and JSON.
+    // The gzip magic is followed by the deflate method and flags whose top
+    // three bits are reserved.
+    if (size >= 4 && bytes[0] == 0x1F && bytes[1] == 0x8B && bytes[2] == 0x08 && (bytes[3] & 0xE0) == 0)
+        return Compression::ZLIB;
+
+    return Compression::NONE;
+}
+
+
+/// \brief An output stream buffer that compresses into another stream.
+///
+/// Data is compressed as it is written, so there is never an uncompressed
+/// copy of the whole stream.
+class CompressingStreamBuffer: public std::streambuf
+{
+public:
+    /// \brief Create a compressing stream buffer.
+    /// \param sink The stream that receives the compressed bytes.
+    /// \param settings The compression settings.
+    /// \throws std::invalid_argument if the compression is not supported.
+    CompressingStreamBuffer(std::ostream& sink, const CompressionSettings& settings):
+        _sink(sink),
+        _settings(settings)
+    {
+        if (!IsCompressionSupported(_settings.compression))
+            throw std::invalid_argument("The requested compression is not supported by this build.");
+
+        _settings.threads = std::max(std::size_t(1), _settings.threads);
+        _settings.blockSize = std::max(std::size_t(1 << 16), _settings.blockSize);
+
+        _input.resize(_parallelBlocks() ? _settings.blockSize : std::size_t(BUFFER_SIZE));
+        _output.resize(BUFFER_SIZE);
+
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+        if (_settings.compression == Compression::ZLIB && !_parallelBlocks())
+        {
+            std::memset(&_zlib, 0, sizeof(_zlib));
+
+            if (deflateInit2(&_zlib, _settings.level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                throw std::runtime_error("Unable to initialize zlib.");
+        }
+#endif
+
+#if defined(OF_SERIALIZER_HAVE_ZSTD)
+        if (_settings.compression == Compression::ZSTD)
+        {
+            _zstd = ZSTD_createCCtx();
+            ZSTD_CCtx_setParameter(_zstd, ZSTD_c_compressionLevel, _settings.level < 0 ? ZSTD_CLEVEL_DEFAULT : _settings.level);
+
+            if (_settings.threads > 1)
+            {
+                // Ignored if libzstd was built without multithreading.
+                ZSTD_CCtx_setParameter(_zstd, ZSTD_c_nbWorkers, int(_settings.threads));
+                ZSTD_CCtx_setParameter(_zstd, ZSTD_c_jobSize, int(_settings.blockSize));
+            }
+        }
+#endif
+
+        setp(_input.data(), _input.data() + _input.size());
+    }
+
+    CompressingStreamBuffer(const CompressingStreamBuffer&) = delete;
+    CompressingStreamBuffer& operator = (const CompressingStreamBuffer&) = delete;
+
+    /// \brief Finish the compressed stream.
+    virtual ~CompressingStreamBuffer()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+        if (_settings.compression == Compression::ZLIB && !_parallelBlocks())
+            deflateEnd(&_zlib);
+#endif
+
+#if defined(OF_SERIALIZER_HAVE_ZSTD)
+        if (_zstd)
+            ZSTD_freeCCtx(_zstd);
+#endif
+    }
+
+    /// \brief Compress any buffered data and finish the compressed stream.
+    ///
+    /// Nothing may be written after the stream buffer is closed.
+    ///
+    /// \returns true if the sink is still good.
+    bool close()
+    {
+        if (!_closed)
+        {
+            _closed = true;
+            _compress(pbase(), std::size_t(pptr() - pbase()), true);
+            setp(nullptr, nullptr);
+            _sink.flush();
+        }
+
+        return bool(_sink);
+    }
+
+    enum
+    {
+        /// \brief The size of the internal buffers.
+        BUFFER_SIZE = 1 << 16
+    };
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (_closed)
+            return traits_type::eof();
+
+        _compress(pbase(), std::size_t(pptr() - pbase()), false);
+        setp(_input.data(), _input.data() + _input.size());
+
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+
+        return _sink ? traits_type::not_eof(c) : traits_type::eof();
+    }
+
+private:
+    bool _parallelBlocks() const
+    {
+        return _settings.compression == Compression::ZLIB && _settings.threads > 1;
+    }
+
+    void _compress(const char* data, std::size_t size, bool finish)
+    {
+        switch (_settings.compression)
+        {
+            case Compression::NONE:
+                _sink.write(data, std::streamsize(size));
+                break;
+            case Compression::ZLIB:
+                if (_parallelBlocks())
+                    _compressBlock(data, size, finish);
+                else
+                    _compressZlib(data, size, finish);
+                break;
+            case Compression::ZSTD:
+                _compressZstd(data, size, finish);
+                break;
+        }
+    }
+
+    void _compressZlib(const char* data, std::size_t size, bool finish)
+    {
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+        _zlib.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        _zlib.avail_in = uInt(size);
+
+        int result = Z_OK;
+
+        do
+        {
+            _zlib.next_out = reinterpret_cast<Bytef*>(_output.data());
+            _zlib.avail_out = uInt(_output.size());
+
+            result = deflate(&_zlib, finish ? Z_FINISH : Z_NO_FLUSH);
+
+            if (result == Z_STREAM_ERROR)
+                throw std::runtime_error("zlib compression failed.");
+
+            _sink.write(_output.data(), std::streamsize(_output.size() - _zlib.avail_out));
+        }
+        while (_zlib.avail_in > 0 || _zlib.avail_out == 0 || (finish && result != Z_STREAM_END));
+#else
+        static_cast<void>(data);
+        static_cast<void>(size);
+        static_cast<void>(finish);
+#endif
+    }
+
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+    static std::vector<char> _deflateBlock(std::vector<char> block, int level)
+    {
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+
+        if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            throw std::runtime_error("Unable to initialize zlib.");
+
+        std::vector<char> compressed(deflateBound(&stream, uLong(block.size())));
+
+        stream.next_in = reinterpret_cast<Bytef*>(block.data());
+        stream.avail_in = uInt(block.size());
+        stream.next_out = reinterpret_cast<Bytef*>(compressed.data());
+        stream.avail_out = uInt(compressed.size());
+
+        int result = deflate(&stream, Z_FINISH);
+        compressed.resize(compressed.size() - stream.avail_out);
+        deflateEnd(&stream);
+
+        if (result != Z_STREAM_END)
+            throw std::runtime_error("zlib compression failed.");
+
+        return compressed;
+    }
+#endif
+
+    void _compressBlock(const char* data, std::size_t size, bool finish)
+    {
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+        if (size > 0)
+            _blocks.emplace_back(data, data + size);
+
+        if (_blocks.size() < _settings.threads && !finish)
+            return;
+
+        // Each block becomes an independent gzip member. Concatenated members
+        // form a valid gzip stream.
+        std::vector<std::future<std::vector<char>>> results;
+
+        for (auto& block: _blocks)
+            results.push_back(std::async(std::launch::async, &CompressingStreamBuffer::_deflateBlock, std::move(block), _settings.level));
+
+        _blocks.clear();
+
+        for (auto& result: results)
+        {
+            std::vector<char> compressed = result.get();
+            _sink.write(compressed.data(), std::streamsize(compressed.size()));
+        }
+#else
+        static_cast<void>(data);
+        static_cast<void>(size);
+        static_cast<void>(finish);
+#endif
+    }
+
+    void _compressZstd(const char* data, std::size_t size, bool finish)
+    {
+#if defined(OF_SERIALIZER_HAVE_ZSTD)
+        ZSTD_inBuffer input = { data, size, 0 };
+        std::size_t remaining = 0;
+
+        do
+        {
+            ZSTD_outBuffer output = { _output.data(), _output.size(), 0 };
+            remaining = ZSTD_compressStream2(_zstd, &output, &input, finish ? ZSTD_e_end : ZSTD_e_continue);
+
+            if (ZSTD_isError(remaining))
+                throw std::runtime_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(remaining));
+
+            _sink.write(_output.data(), std::streamsize(output.pos));
+        }
+        while (finish ? remaining != 0 : input.pos < input.size);
+#else
+        static_cast<void>(data);
+        static_cast<void>(size);
+        static_cast<void>(finish);
+#endif
+    }
+
+    /// \brief The stream receiving compressed bytes.
+    std::ostream& _sink;
+
+    /// \brief The compression settings.
+    CompressionSettings _settings;
+
+    /// \brief Uncompressed bytes waiting to be compressed.
+    std::vector<char> _input;
+
+    /// \brief Compressed bytes waiting to be written.
+    std::vector<char> _output;
+
+    /// \brief Blocks waiting to be compressed in parallel.
+    std::vector<std::vector<char>> _blocks;
+
+    /// \brief True once the compressed stream is finished.
+    bool _closed = false;
+
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+    z_stream _zlib;
+#endif
+
+#if defined(OF_SERIALIZER_HAVE_ZSTD)
+    ZSTD_CCtx* _zstd = nullptr;
+#endif
+
+};
+
+
+/// \brief An input stream buffer that decompresses another stream.
+///
+/// The compression format is given or detected from the first bytes of the
+/// source. Uncompressed sources are passed through unchanged.
+class DecompressingStreamBuffer: public std::streambuf
+{
+public:
+    /// \brief Create a decompressing stream buffer that detects the compression.
+    /// \param source The stream providing compressed bytes.
+    /// \throws std::runtime_error if the detected compression is not supported.
+    DecompressingStreamBuffer(std::istream& source):
+        _source(source),
+        _input(BUFFER_SIZE),
+        _output(BUFFER_SIZE)
+    {
+        _fill();
+        _init(DetectCompression(_input.data() + _inputPosition, _inputSize - _inputPosition));
+    }
+
+    /// \brief Create a decompressing stream buffer for a known compression.
+    /// \param source The stream providing compressed bytes.
+    /// \param compression The compression of the source.
+    /// \throws std::runtime_error if the compression is not supported.
+    DecompressingStreamBuffer(std::istream& source, Compression compression):
+        _source(source),
+        _input(BUFFER_SIZE),
+        _output(BUFFER_SIZE)
+    {
+        _init(compression);
+    }
+
+    DecompressingStreamBuffer(const DecompressingStreamBuffer&) = delete;
+    DecompressingStreamBuffer& operator = (const DecompressingStreamBuffer&) = delete;
+
+    virtual ~DecompressingStreamBuffer()
+    {
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+        if (_compression == Compression::ZLIB)
+            inflateEnd(&_zlib);
+#endif
+
+#if defined(OF_SERIALIZER_HAVE_ZSTD)
+        if (_zstd)
+            ZSTD_freeDCtx(_zstd);
+#endif
+    }
+
+    /// \returns the compression of the source.
+    Compression compression() const
+    {
+        return _compression;
+    }
+
+    enum
+    {
+        /// \brief The size of the internal buffers.
+        BUFFER_SIZE = 1 << 16
+    };
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+
+        std::size_t size = 0;
+
+        while (size == 0)
+        {
+            // The decompressor may hold output after consuming all input.
+            if (_inputPosition == _inputSize && !_pending && !_fill())
+                return traits_type::eof();
+
+            size = _decompress();
+        }
+
+        setg(_output.data(), _output.data(), _output.data() + size);
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    void _init(Compression compression)
+    {
+        _compression = compression;
+
+        if (!IsCompressionSupported(_compression))
+            throw std::runtime_error("The stream's compression is not supported by this build.");
+
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+        if (_compression == Compression::ZLIB)
+        {
+            std::memset(&_zlib, 0, sizeof(_zlib));
+
+            // Automatically accept both gzip and zlib headers.
+            if (inflateInit2(&_zlib, 15 + 32) != Z_OK)
+                throw std::runtime_error("Unable to initialize zlib.");
+        }
+#endif
+
+#if defined(OF_SERIALIZER_HAVE_ZSTD)
+        if (_compression == Compression::ZSTD)
+            _zstd = ZSTD_createDCtx();
+#endif
+
+        setg(_output.data(), _output.data(), _output.data());
+    }
+
+    /// \brief Read more compressed bytes from the source.
+    /// \returns false if the source is exhausted.
+    bool _fill()
+    {
+        if (_inputPosition < _inputSize)
+            return true;
+
+        _source.read(_input.data(), std::streamsize(_input.size()));
+        _inputSize = std::size_t(_source.gcount());
+        _inputPosition = 0;
+        return _inputSize > 0;
+    }
+
+    /// \brief Decompress from the input buffer into the output buffer.
+    ///
+    /// Sets _pending if the output buffer was filled, as the decompressor may
+    /// then hold more output.
+    ///
+    /// \returns the number of decompressed bytes.
+    std::size_t _decompress()
+    {
+        switch (_compression)
+        {
+            case Compression::NONE:
+            {
+                std::size_t size = std::min(_output.size(), _inputSize - _inputPosition);
+                std::memcpy(_output.data(), _input.data() + _inputPosition, size);
+                _inputPosition += size;
+                return size;
+            }
+            case Compression::ZLIB:
+            {
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+                _zlib.next_in = reinterpret_cast<Bytef*>(_input.data() + _inputPosition);
+                _zlib.avail_in = uInt(_inputSize - _inputPosition);
+                _zlib.next_out = reinterpret_cast<Bytef*>(_output.data());
+                _zlib.avail_out = uInt(_output.size());
+
+                int result = inflate(&_zlib, Z_NO_FLUSH);
+
+                if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+                    throw std::runtime_error("zlib decompression failed.");
+
+                _inputPosition = _inputSize - _zlib.avail_in;
+
+                // Continue with the next member of a multi-member gzip stream.
+                if (result == Z_STREAM_END)
+                    inflateReset(&_zlib);
+
+                _pending = _zlib.avail_out == 0;
+                return _output.size() - _zlib.avail_out;
+#else
+                return 0;
+#endif
+            }
+            case Compression::ZSTD:
+            {
+#if defined(OF_SERIALIZER_HAVE_ZSTD)
+                ZSTD_inBuffer input = { _input.data(), _inputSize, _inputPosition };
+                ZSTD_outBuffer output = { _output.data(), _output.size(), 0 };
+
+                std::size_t result = ZSTD_decompressStream(_zstd, &output, &input);
+
+                if (ZSTD_isError(result))
+                    throw std::runtime_error(std::string("zstd decompression failed: ") + ZSTD_getErrorName(result));
+
+                _inputPosition = input.pos;
+                _pending = output.pos == output.size && result != 0;
+                return output.pos;
+#else
+                return 0;
+#endif
+            }
+        }
+
+        return 0;
+    }
+
+    /// \brief The stream providing compressed bytes.
+    std::istream& _source;
+
+    /// \brief The detected compression.
+    Compression _compression = Compression::NONE;
+
+    /// \brief Compressed bytes read from the source.
+    std::vector<char> _input;
+    std::size_t _inputPosition = 0;
+    std::size_t _inputSize = 0;
+
+    /// \brief Decompressed bytes.
+    std::vector<char> _output;
+
+    /// \brief True if the decompressor may hold output not yet returned.
+    bool _pending = false;
+
+#if defined(OF_SERIALIZER_HAVE_ZLIB)
+    z_stream _zlib;
+#endif
+
+#if defined(OF_SERIALIZER_HAVE_ZSTD)
+    ZSTD_DCtx* _zstd = nullptr;
+#endif
+
+};
+
+
+/// \brief An output stream that compresses into another stream.
+class CompressingOutputStream: public std::ostream
+{
+public:
+    /// \brief Create a compressing output stream.
+    /// \param sink The stream that receives the compressed bytes.
+    /// \param settings The compression settings.
+    CompressingOutputStream(std::ostream& sink, const CompressionSettings& settings):
+        std::ostream(nullptr),
+        _buffer(sink, settings)
+    {
+        rdbuf(&_buffer);
+    }
+
+    /// \brief Finish the compressed stream.
+    /// \returns true if successful.
+    bool close()
+    {
+        if (!_buffer.close())
+            setstate(std::ios::badbit);
+
+        return good();
+    }
+
+private:
+    CompressingStreamBuffer _buffer;
+
+};
+
+
+/// \brief An input stream that decompresses another stream.
+class DecompressingInputStream: public std::istream
+{
+public:
+    /// \brief Create a decompressing input stream that detects the compression.
+    /// \param source The stream providing compressed or uncompressed bytes.
+    DecompressingInputStream(std::istream& source):
+        std::istream(nullptr),
+        _buffer(source)
+    {
+        rdbuf(&_buffer);
+    }
+
+    /// \brief Create a decompressing input stream for a known compression.
+    /// \param source The stream providing compressed or uncompressed bytes.
+    /// \param compression The compression of the source.
+    DecompressingInputStream(std::istream& source, Compression compression):
+        std::istream(nullptr),
+        _buffer(source, compression)
+    {
+        rdbuf(&_buffer);
+    }
+
+    /// \returns the compression of the source.
+    Compression compression() const
+    {
+        return _buffer.compression();
+    }
+
+private:
+    DecompressingStreamBuffer _buffer;
+
+};
+
+
+/// \brief A stream buffer that reads from or appends to memory.
+class MemoryStreamBuffer: public std::streambuf
+{
+public:
+    /// \brief Read from a block of memory.
+    /// \param data The bytes to read.
+    /// \param size The number of bytes.
+    MemoryStreamBuffer(const void* data, std::size_t size)
+    {
+        char* begin = const_cast<char*>(static_cast<const char*>(data));
+        setg(begin, begin, begin + size);
+    }
+
+    /// \brief Append to a byte vector.
+    /// \param bytes The vector to append to.
+    MemoryStreamBuffer(std::vector<uint8_t>& bytes): _bytes(&bytes)
+    {
+    }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (!_bytes)
+            return traits_type::eof();
+
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+            _bytes->push_back(uint8_t(traits_type::to_char_type(c)));
+
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize size) override
+    {
+        if (!_bytes)
+            return 0;
+
+        _bytes->insert(_bytes->end(), data, data + size);
+        return size;
+    }
+
+private:
+    std::vector<uint8_t>* _bytes = nullptr;
+
+};
+
+
+/// \brief Compress a block of bytes.
+/// \param data The bytes to compress.
+/// \param size The number of bytes.
+/// \param settings The compression settings.
+/// \returns the compressed bytes.
+/// \throws std::runtime_error if compression fails.
+inline std::vector<uint8_t> CompressBytes(const void* data,
+                                          std::size_t size,
+                                          const CompressionSettings& settings)
+{
+    std::vector<uint8_t> bytes;
+    MemoryStreamBuffer buffer(bytes);
+    std::ostream sink(&buffer);
+
+    CompressingOutputStream stream(sink, settings);
+    stream.write(static_cast<const char*>(data), std::streamsize(size));
+
+    if (!stream.close())
+        throw std::runtime_error("Unable to compress.");
+
+    return bytes;
+}
+
+
+/// \brief Decompress a block of bytes of a known decompressed size.
+///
+/// The compression is detected automatically.
+///
+/// \param data The compressed bytes.
+/// \param size The number of compressed bytes.
+/// \param output The decompressed bytes.
+/// \param outputSize The expected number of decompressed bytes.
+/// \returns true if exactly \p outputSize bytes were decompressed.
+inline bool DecompressBytes(const void* data,
+                            std::size_t size,
+                            void* output,
+                            std::size_t outputSize)
+{
+    MemoryStreamBuffer buffer(data, size);
+    std::istream source(&buffer);
+
+    DecompressingInputStream stream(source);
+    stream.read(static_cast<char*>(output), std::streamsize(outputSize));
+
+    return std::size_t(stream.gcount()) == outputSize && stream.peek() == std::char_traits<char>::eof();
+}
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_COMPRESSION_H
@@ -0,0 +1,30 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_CONSTANTS_H
+#define OF_SERIALIZER_CONSTANTS_H
+
+
+#include "json.hpp"
+#include "ofConstants.h"
+
+
+NLOHMANN_JSON_SERIALIZE_ENUM( ofTargetPlatform, {
+    { OF_TARGET_OSX, "OF_TARGET_OSX" },
+    { OF_TARGET_MINGW, "OF_TARGET_MINGW"},
+    { OF_TARGET_WINVS, "OF_TARGET_WINVS"},
+    { OF_TARGET_IOS, "OF_TARGET_IOS" },
+    { OF_TARGET_ANDROID, "OF_TARGET_ANDROID"},
+    { OF_TARGET_LINUX, "OF_TARGET_LINUX"},
+    { OF_TARGET_LINUX64, "OF_TARGET_LINUX64" },
+    { OF_TARGET_LINUXARMV6L, "OF_TARGET_LINUXARMV6L"},
+    { OF_TARGET_LINUXARMV7L, "OF_TARGET_LINUXARMV7L"},
+    { OF_TARGET_EMSCRIPTEN, "OF_TARGET_EMSCRIPTEN" }
+})
+
+
+#endif // OF_SERIALIZER_CONSTANTS_H
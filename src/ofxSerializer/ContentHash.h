@@ -0,0 +1,410 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_CONTENT_HASH_H
+#define OF_SERIALIZER_CONTENT_HASH_H
+
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "json.hpp"
+#include "ofxSerializer/Parameter.h"
+#include "ofMesh.h"
+#include "ofParameter.h"
+#include "ofPath.h"
+#include "ofPolyline.h"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief A streaming 64-bit xxHash (XXH64) of an object's content.
+class ContentHasher
+{
+public:
+    /// \brief Create a hasher.
+    /// \param seed The hash seed.
+    ContentHasher(uint64_t seed = 0): _seed(seed)
+    {
+        _state[0] = seed + PRIME_1 + PRIME_2;
+        _state[1] = seed + PRIME_2;
+        _state[2] = seed;
+        _state[3] = seed - PRIME_1;
+    }
+
+    /// \brief Add bytes to the hash.
+    /// \param data The bytes to add.
+    /// \param size The number of bytes.
+    void update(const void* data, std::size_t size)
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        const uint8_t* end = p + size;
+
+        _total += size;
+
+        if (_bufferSize + size < 32)
+        {
+            if (size > 0)
+                std::memcpy(_buffer + _bufferSize, p, size);
+            _bufferSize += size;
+            return;
+        }
+
+        if (_bufferSize > 0)
+        {
+            std::size_t fill = 32 - _bufferSize;
+            std::memcpy(_buffer + _bufferSize, p, fill);
+            _consume(_buffer);
+            p += fill;
+            _bufferSize = 0;
+        }
+
+        while (p + 32 <= end)
+        {
+            _consume(p);
+            p += 32;
+        }
+
+        _bufferSize = std::size_t(end - p);
+
+        if (_bufferSize > 0)
+            std::memcpy(_buffer, p, _bufferSize);
+    }
+
+    /// \brief Add a trivially copyable value to the hash.
+    /// \param value The value to add.
+    template<typename T>
+    void updateValue(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "The value must be trivially copyable.");
+        update(&value, sizeof(T));
+    }
+
+    /// \brief Add the elements of a vector of trivially copyable values.
+    /// \param values The values to add.
+    template<typename T>
+    void updateValues(const std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "The values must be trivially copyable.");
+        updateValue(uint64_t(values.size()));
+        update(values.data(), values.size() * sizeof(T));
+    }
+
+    /// \returns the hash of the bytes added so far.
+    uint64_t digest() const
+    {
+        uint64_t h = 0;
+
+        if (_total >= 32)
+        {
+            h = _rotl(_state[0], 1) + _rotl(_state[1], 7) + _rotl(_state[2], 12) + _rotl(_state[3], 18);
+            h = _merge(h, _state[0]);
+            h = _merge(h, _state[1]);
+            h = _merge(h, _state[2]);
+            h = _merge(h, _state[3]);
+        }
+        else
+        {
+            h = _seed + PRIME_5;
+        }
+
+        h += _total;
+
+        const uint8_t* p = _buffer;
+        const uint8_t* end = _buffer + _bufferSize;
+
+        while (p + 8 <= end)
+        {
+            h ^= _round(0, _read64(p));
+            h = _rotl(h, 27) * PRIME_1 + PRIME_4;
+            p += 8;
+        }
+
+        if (p + 4 <= end)
+        {
+            h ^= uint64_t(_read32(p)) * PRIME_1;
+            h = _rotl(h, 23) * PRIME_2 + PRIME_3;
+            p += 4;
+        }
+
+        while (p < end)
+        {
+            h ^= (*p) * PRIME_5;
+            h = _rotl(h, 11) * PRIME_1;
+            ++p;
+        }
+
+        h ^= h >> 33;
+        h *= PRIME_2;
+        h ^= h >> 29;
+        h *= PRIME_3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    /// \brief Hash a block of bytes.
+    /// \param data The bytes to hash.
+    /// \param size The number of bytes.
+    /// \param seed The hash seed.
+    /// \returns the hash.
+    static uint64_t hash(const void* data, std::size_t size, uint64_t seed = 0)
+    {
+        ContentHasher hasher(seed);
+        hasher.update(data, size);
+        return hasher.digest();
+    }
+
+private:
+    static const uint64_t PRIME_1 = 11400714785074694791ULL;
+    static const uint64_t PRIME_2 = 14029467366897019727ULL;
+    static const uint64_t PRIME_3 = 1609587929392839161ULL;
+    static const uint64_t PRIME_4 = 9650029242287828579ULL;
+    static const uint64_t PRIME_5 = 2870177450012600261ULL;
+
+    static uint64_t _rotl(uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static uint64_t _read64(const uint8_t* p)
+    {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static uint32_t _read32(const uint8_t* p)
+    {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static uint64_t _round(uint64_t acc, uint64_t input)
+    {
+        acc += input * PRIME_2;
+        acc = _rotl(acc, 31);
+        return acc * PRIME_1;
+    }
+
+    static uint64_t _merge(uint64_t acc, uint64_t value)
+    {
+        acc ^= _round(0, value);
+        return acc * PRIME_1 + PRIME_4;
+    }
+
+    void _consume(const uint8_t* p)
+    {
+        _state[0] = _round(_state[0], _read64(p));
+        _state[1] = _round(_state[1], _read64(p + 8));
+        _state[2] = _round(_state[2], _read64(p + 16));
+        _state[3] = _round(_state[3], _read64(p + 24));
+    }
+
+    uint64_t _seed = 0;
+    uint64_t _state[4];
+    uint8_t _buffer[32];
+    std::size_t _bufferSize = 0;
+    uint64_t _total = 0;
+
+};
+
+
+/// \brief Hash a trivially copyable value, such as a glm::mat4.
+template<typename T>
+inline typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+HashContent(ContentHasher& hasher, const T& value)
+{
+    hasher.updateValue(value);
+}
+
+
+inline void HashContent(ContentHasher& hasher, const std::string& value)
+{
+    hasher.updateValue(uint64_t(value.size()));
+    hasher.update(value.data(), value.size());
+}
+
+
+/// \brief Hash a JSON value.
+///
+/// This is a template so that other types are not implicitly converted to
+/// JSON to call it.
+template<typename Json>
+inline typename std::enable_if<std::is_same<Json, nlohmann::json>::value>::type
+HashContent(ContentHasher& hasher, const Json& value)
+{
+    hasher.updateValue(uint8_t(value.type()));
+
+    switch (value.type())
+    {
+        case nlohmann::json::value_t::object:
+            hasher.updateValue(uint64_t(value.size()));
+            for (auto it = value.begin(); it != value.end(); ++it)
+            {
+                HashContent(hasher, it.key());
+                HashContent(hasher, it.value());
+            }
+            break;
+        case nlohmann::json::value_t::array:
+            hasher.updateValue(uint64_t(value.size()));
+            for (const auto& element: value)
+                HashContent(hasher, element);
+            break;
+        case nlohmann::json::value_t::string:
+            HashContent(hasher, value.template get_ref<const std::string&>());
+            break;
+        case nlohmann::json::value_t::boolean:
+            hasher.updateValue(value.template get<bool>());
+            break;
+        case nlohmann::json::value_t::number_integer:
+            hasher.updateValue(value.template get<int64_t>());
+            break;
+        case nlohmann::json::value_t::number_unsigned:
+            hasher.updateValue(value.template get<uint64_t>());
+            break;
+        case nlohmann::json::value_t::number_float:
+            hasher.updateValue(value.template get<double>());
+            break;
+        case nlohmann::json::value_t::binary:
+            hasher.updateValues(value.get_binary());
+            break;
+        default:
+            break;
+    }
+}
+
+
+/// \brief Hash the attributes of a mesh without encoding it.
+template<class V, class N, class C, class T>
+inline void HashContent(ContentHasher& hasher, const ofMesh_<V, N, C, T>& value)
+{
+    hasher.updateValue(int32_t(value.getMode()));
+    hasher.updateValue(uint8_t(value.usingColors()));
+    hasher.updateValue(uint8_t(value.usingTextures()));
+    hasher.updateValue(uint8_t(value.usingNormals()));
+    hasher.updateValue(uint8_t(value.usingIndices()));
+    hasher.updateValues(value.getVertices());
+    hasher.updateValues(value.getNormals());
+    hasher.updateValues(value.getColors());
+    hasher.updateValues(value.getTexCoords());
+    hasher.updateValues(value.getIndices());
+}
+
+
+/// \brief Hash the vertices of a polyline without encoding it.
+template<typename VertexType>
+inline void HashContent(ContentHasher& hasher, const ofPolyline_<VertexType>& value)
+{
+    hasher.updateValue(uint8_t(value.isClosed()));
+    hasher.updateValues(value.getVertices());
+}
+
+
+/// \brief Hash the commands and style of a path without tessellating it.
+inline void HashContent(ContentHasher& hasher, const ofPath& value)
+{
+    const auto& commands = value.getCommands();
+    hasher.updateValue(uint64_t(commands.size()));
+
+    // Commands are hashed by field so that padding never affects the hash.
+    for (const auto& command: commands)
+    {
+        hasher.updateValue(int32_t(command.type));
+        hasher.updateValue(command.to);
+        hasher.updateValue(command.cp1);
+        hasher.updateValue(command.cp2);
+        hasher.updateValue(command.radiusX);
+        hasher.updateValue(command.radiusY);
+        hasher.updateValue(command.angleBegin);
+        hasher.updateValue(command.angleEnd);
+    }
+
+    hasher.updateValue(int32_t(value.getMode()));
+    hasher.updateValue(int32_t(value.getWindingMode()));
+    hasher.updateValue(uint8_t(value.isFilled()));
+    hasher.updateValue(value.getFillColor());
+    hasher.updateValue(value.getStrokeColor());
+    hasher.updateValue(value.getStrokeWidth());
+    hasher.updateValue(int32_t(value.getCurveResolution()));
+    hasher.updateValue(int32_t(value.getCircleResolution()));
+}
+
+
+/// \brief Hash the current values of a parameter group.
+///
+/// Values are hashed as ParameterToJson() serializes them, so float values
+/// are hashed exactly rather than as the rounded text of toString().
+inline void HashContent(ContentHasher& hasher, const ofParameterGroup& value)
+{
+    for (const auto& child: value)
+    {
+        HashContent(hasher, child->getEscapedName());
+
+        if (auto group = dynamic_cast<const ofParameterGroup*>(child.get()))
+            HashContent(hasher, *group);
+        else
+            HashContent(hasher, ParameterToJson(*child));
+    }
+}
+
+
+/// \brief True if a HashContent() overload hashes T directly.
+template<typename T, typename = void>
+struct HasHashContent: std::false_type
+{
+};
+
+
+template<typename T>
+struct HasHashContent<T, decltype(HashContent(std::declval<ContentHasher&>(), std::declval<const T&>()), void())>: std::true_type
+{
+};
+
+
+/// \brief Compute the content hash of a value.
+///
+/// Values are hashed through HashContent() overloads, which read the value's
+/// data directly instead of encoding it. Add an overload in the value's
+/// namespace to hash a type cheaply.
+///
+/// \param value The value to hash.
+/// \returns the 64-bit content hash.
+template<typename T>
+typename std::enable_if<HasHashContent<T>::value, uint64_t>::type
+ContentHash(const T& value)
+{
+    ContentHasher hasher;
+    HashContent(hasher, value);
+    return hasher.digest();
+}
+
+
+/// \brief Compute the content hash of a value through its JSON representation.
+///
+/// This is used for types without a HashContent() overload, and costs about
+/// as much as serializing the value.
+///
+/// \param value The value to hash.
+/// \returns the 64-bit content hash.
+template<typename T>
+typename std::enable_if<!HasHashContent<T>::value, uint64_t>::type
+ContentHash(const T& value)
+{
+    return ContentHash(nlohmann::json(value));
+}
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_CONTENT_HASH_H
@@ -0,0 +1,272 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_DOCUMENT_H
+#define OF_SERIALIZER_DOCUMENT_H
+
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "ofxSerializer/Compression.h"
+#include "ofxSerializer/JsonWriter.h"
+#include "ofFileUtils.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief An encoding of a serialized document.
+enum class DocumentFormat
+{
+    /// \brief JSON text.
+    JSON,
+    /// \brief JSON text with numbers that are exactly representable as
+    ///        float printed as the shortest float. \sa JsonWriter
+    JSON_FLOAT,
+    /// \brief Concise Binary Object Representation.
+    CBOR,
+    /// \brief MessagePack.
+    MESSAGEPACK,
+    /// \brief Universal Binary JSON.
+    UBJSON,
+    /// \brief Binary JSON. The document must be an object.
+    BSON
+};
+
+
+/// \brief Write a document to a stream.
+/// \param stream The stream to write to.
+/// \param j The document to write.
+/// \param format The document format.
+/// \param indent The JSON text indentation, or -1 for compact output.
+inline void WriteDocument(std::ostream& stream,
+                          const nlohmann::json& j,
+                          DocumentFormat format = DocumentFormat::JSON,
+                          int indent = -1)
+{
+    switch (format)
+    {
+        case DocumentFormat::JSON:
+            if (indent >= 0)
+                stream << std::setw(indent);
+            stream << j;
+            break;
+        case DocumentFormat::JSON_FLOAT:
+            WriteJson(stream, j, indent);
+            break;
+        case DocumentFormat::CBOR:
+            nlohmann::json::to_cbor(j, stream);
+            break;
+        case DocumentFormat::MESSAGEPACK:
+            nlohmann::json::to_msgpack(j, stream);
+            break;
+        case DocumentFormat::UBJSON:
+            nlohmann::json::to_ubjson(j, stream);
+            break;
+        case DocumentFormat::BSON:
+            nlohmann::json::to_bson(j, stream);
+            break;
+    }
+}
+
+
+/// \brief Encode a document to bytes.
+/// \param j The document to encode.
+/// \param format The document format.
+/// \param indent The JSON text indentation, or -1 for compact output.
+/// \returns the encoded document.
+inline std::vector<uint8_t> EncodeDocument(const nlohmann::json& j,
+                                           DocumentFormat format = DocumentFormat::JSON,
+                                           int indent = -1)
+{
+    switch (format)
+    {
+        case DocumentFormat::JSON:
+        {
+            std::string text = j.dump(indent);
+            return std::vector<uint8_t>(text.begin(), text.end());
+        }
+        case DocumentFormat::JSON_FLOAT:
+        {
+            std::string text = DumpJson(j, indent);
+            return std::vector<uint8_t>(text.begin(), text.end());
+        }
+        case DocumentFormat::CBOR:
+            return nlohmann::json::to_cbor(j);
+        case DocumentFormat::MESSAGEPACK:
+            return nlohmann::json::to_msgpack(j);
+        case DocumentFormat::UBJSON:
+            return nlohmann::json::to_ubjson(j);
+        case DocumentFormat::BSON:
+            return nlohmann::json::to_bson(j);
+    }
+
+    return std::vector<uint8_t>();
+}
+
+
+/// \brief Read a document from a stream.
+/// \param stream The stream to read from.
+/// \param format The document format.
+/// \returns the document.
+/// \throws nlohmann::json::exception if the document is invalid.
+inline nlohmann::json ReadDocument(std::istream& stream,
+                                   DocumentFormat format = DocumentFormat::JSON)
+{
+    switch (format)
+    {
+        case DocumentFormat::JSON:
+        case DocumentFormat::JSON_FLOAT:
+            return nlohmann::json::parse(stream);
+        case DocumentFormat::CBOR:
+            return nlohmann::json::from_cbor(stream);
+        case DocumentFormat::MESSAGEPACK:
+            return nlohmann::json::from_msgpack(stream);
+        case DocumentFormat::UBJSON:
+            return nlohmann::json::from_ubjson(stream);
+        case DocumentFormat::BSON:
+            return nlohmann::json::from_bson(stream);
+    }
+
+    return nullptr;
+}
+
+
+/// \brief Save a document to a file, optionally compressed.
+///
+/// The document is encoded and compressed in a single streaming pass.
+///
+/// \param filename The file to write.
+/// \param j The document to save.
+/// \param format The document format.
+/// \param compression The compression settings.
+/// \param indent The JSON text indentation, or -1 for compact output.
+/// \returns true if successful.
+inline bool SaveDocument(const std::string& filename,
+                         const nlohmann::json& j,
+                         DocumentFormat format = DocumentFormat::JSON,
+                         const CompressionSettings& compression = CompressionSettings(),
+                         int indent = -1)
+{
+    std::ofstream file(ofToDataPath(filename, true), std::ios::binary | std::ios::trunc);
+
+    if (!file)
+    {
+        ofLogError("SaveDocument") << "Unable to open " << filename;
+        return false;
+    }
+
+    try
+    {
+        CompressingOutputStream stream(file, compression);
+        WriteDocument(stream, j, format, indent);
+
+        if (!stream.close())
+        {
+            ofLogError("SaveDocument") << "Unable to write " << filename;
+            return false;
+        }
+    }
+    catch (const std::exception& exc)
+    {
+        ofLogError("SaveDocument") << "Unable to save " << filename << ": " << exc.what();
+        return false;
+    }
+
+    return true;
+}
+
+
+/// \brief Load a document from a file with a known compression.
+/// \param filename The file to read.
+/// \param format The document format.
+/// \param compression The compression of the file.
+/// \returns the document, or null if it could not be loaded.
+inline nlohmann::json LoadDocument(const std::string& filename,
+                                   DocumentFormat format,
+                                   Compression compression)
+{
+    std::ifstream file(ofToDataPath(filename, true), std::ios::binary);
+
+    if (!file)
+    {
+        ofLogError("LoadDocument") << "Unable to open " << filename;
+        return nullptr;
+    }
+
+    try
+    {
+        DecompressingInputStream stream(file, compression);
+        return ReadDocument(stream, format);
+    }
+    catch (const std::exception& exc)
+    {
+        ofLogError("LoadDocument") << "Unable to load " << filename << ": " << exc.what();
+    }
+
+    return nullptr;
+}
+
+
+/// \brief Load a document from a file.
+///
+/// Compression is detected automatically and decompressed while parsing.
+/// An uncompressed BSON document starts with its size, which can look like
+/// a gzip header, so a BSON file whose first four bytes give the file size
+/// is read as uncompressed.
+///
+/// \param filename The file to read.
+/// \param format The document format.
+/// \returns the document, or null if it could not be loaded.
+inline nlohmann::json LoadDocument(const std::string& filename,
+                                   DocumentFormat format = DocumentFormat::JSON)
+{
+    std::ifstream file(ofToDataPath(filename, true), std::ios::binary | std::ios::ate);
+
+    if (!file)
+    {
+        ofLogError("LoadDocument") << "Unable to open " << filename;
+        return nullptr;
+    }
+
+    const uint64_t size = uint64_t(file.tellg());
+    file.seekg(0);
+
+    uint8_t header[4] = { 0 };
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    const std::size_t headerSize = std::size_t(file.gcount());
+    file.clear();
+    file.seekg(0);
+
+    Compression compression = DetectCompression(reinterpret_cast<const char*>(header), headerSize);
+
+    if (format == DocumentFormat::BSON && compression == Compression::ZLIB)
+    {
+        const uint64_t documentSize = uint64_t(header[0])
+                                    | uint64_t(header[1]) << 8
+                                    | uint64_t(header[2]) << 16
+                                    | uint64_t(header[3]) << 24;
+
+        if (documentSize == size)
+            compression = Compression::NONE;
+    }
+
+    file.close();
+    return LoadDocument(filename, format, compression);
+}
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_DOCUMENT_H
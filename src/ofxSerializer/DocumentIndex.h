@@ -0,0 +1,551 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_DOCUMENT_INDEX_H
+#define OF_SERIALIZER_DOCUMENT_INDEX_H
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "json.hpp"
+#include "ofxSerializer/FileStamp.h"
+#include "ofFileUtils.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief A byte range index over the values of a JSON document.
+///
+/// The index is built with a single structural scan of the document text that
+/// records the byte range of every value down to a maximum depth, addressed
+/// by its JSON pointer. Values can then be parsed individually without
+/// parsing the rest of the document.
+class DocumentIndex
+{
+public:
+    /// \brief An indexed value.
+    struct Entry
+    {
+        /// \brief The JSON pointer of the value.
+        std::string pointer;
+
+        /// \brief The byte offset of the first character of the value.
+        uint64_t begin = 0;
+
+        /// \brief The byte offset one past the last character of the value.
+        uint64_t end = 0;
+    };
+
+    /// \brief Build an index by scanning a document.
+    /// \param path The absolute path of the JSON document.
+    /// \param maxDepth The maximum depth of indexed values. The depth of a
+    ///        value is the number of containers enclosing it, so 1 indexes
+    ///        only the members of the root object or array and 2 also
+    ///        indexes their members.
+    /// \returns the index.
+    /// \throws std::runtime_error if the document cannot be read or is malformed.
+    static DocumentIndex build(const std::string& path, std::size_t maxDepth = 1)
+    {
+        std::ifstream stream(path, std::ios::binary);
+
+        if (!stream)
+            throw std::runtime_error("Unable to open " + path);
+
+        DocumentIndex index;
+        index._source = FileStamp::fromFile(path);
+        index._maxDepth = maxDepth;
+
+        Scanner scanner(index, maxDepth);
+
+        std::vector<char> chunk(1 << 20);
+
+        while (stream)
+        {
+            stream.read(chunk.data(), std::streamsize(chunk.size()));
+            scanner.scan(chunk.data(), std::size_t(stream.gcount()));
+        }
+
+        scanner.finish();
+
+        // Values are recorded as they end, so containers follow their members.
+        std::stable_sort(index._entries.begin(),
+                         index._entries.end(),
+                         [](const Entry& a, const Entry& b) { return a.begin < b.begin; });
+
+        for (std::size_t i = 0; i < index._entries.size(); ++i)
+            index._lookup[index._entries[i].pointer] = i;
+
+        return index;
+    }
+
+    /// \brief Load the index persisted next to a document or rebuild it.
+    ///
+    /// The persisted index is used if it was built from a document with the
+    /// same size and modification time and with the same maximum depth.
+    /// Otherwise the index is rebuilt and saved.
+    ///
+    /// Modification times have a resolution of one second, so an index is
+    /// not saved for a document modified within the last two seconds, which
+    /// could be rewritten with the same size and time.
+    ///
+    /// \param filename The JSON document.
+    /// \param maxDepth The maximum depth of indexed values, as in build().
+    /// \returns the index.
+    static DocumentIndex load(const std::string& filename, std::size_t maxDepth = 1)
+    {
+        std::string path = ofToDataPath(filename, true);
+        std::string indexPath = indexPathFor(path);
+
+        FileStamp source = FileStamp::fromFile(path);
+
+        try
+        {
+            if (FileStamp::fromFile(indexPath).exists)
+            {
+                DocumentIndex index = fromJson(nlohmann::json::from_cbor(ofBufferFromFile(indexPath, true)));
+
+                if (index._source == source && index._maxDepth == maxDepth)
+                    return index;
+            }
+        }
+        catch (const std::exception& exc)
+        {
+            ofLogWarning("DocumentIndex::load") << "Rebuilding invalid index " << indexPath << ": " << exc.what();
+        }
+
+        DocumentIndex index = build(path, maxDepth);
+
+        if (index._source.modified >= int64_t(std::time(nullptr)) - 2)
+            std::remove(indexPath.c_str());
+        else if (!index.save(indexPath))
+            ofLogWarning("DocumentIndex::load") << "Unable to save " << indexPath;
+
+        return index;
+    }
+
+    /// \brief Save the index.
+    /// \param path The absolute path of the index file.
+    /// \returns true if successful.
+    bool save(const std::string& path) const
+    {
+        std::vector<uint8_t> bytes = nlohmann::json::to_cbor(toJson());
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        return bool(stream.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size())));
+    }
+
+    /// \brief Find an indexed value.
+    /// \param pointer The JSON pointer of the value.
+    /// \returns the entry or nullptr if the value is not indexed.
+    const Entry* find(const std::string& pointer) const
+    {
+        auto iter = _lookup.find(pointer);
+        return iter != _lookup.end() ? &_entries[iter->second] : nullptr;
+    }
+
+    /// \returns all entries in document order.
+    const std::vector<Entry>& entries() const
+    {
+        return _entries;
+    }
+
+    /// \returns the stamp of the indexed document.
+    const FileStamp& source() const
+    {
+        return _source;
+    }
+
+    /// \returns the path of the index persisted next to \p path.
+    static std::string indexPathFor(const std::string& path)
+    {
+        return path + ".index";
+    }
+
+    /// \returns the index as JSON.
+    nlohmann::json toJson() const
+    {
+        nlohmann::json j;
+        j["version"] = 1;
+        j["source"] = _source;
+        j["max_depth"] = _maxDepth;
+
+        nlohmann::json entries = nlohmann::json::array();
+        for (const auto& entry: _entries)
+            entries.push_back({ entry.pointer, entry.begin, entry.end });
+
+        j["entries"] = std::move(entries);
+        return j;
+    }
+
+    /// \brief Create an index from JSON written by toJson().
+    /// \param j The index as JSON.
+    /// \returns the index.
+    static DocumentIndex fromJson(const nlohmann::json& j)
+    {
+        if (j.value("version", 0) != 1)
+            throw std::runtime_error("Unsupported index version.");
+
+        DocumentIndex index;
+        index._source = j.at("source").get<FileStamp>();
+        index._maxDepth = j.at("max_depth");
+
+        for (const auto& entry: j.at("entries"))
+            index._add(entry.at(0), entry.at(1), entry.at(2));
+
+        return index;
+    }
+
+private:
+    void _add(const std::string& pointer, uint64_t begin, uint64_t end)
+    {
+        _lookup[pointer] = _entries.size();
+        _entries.push_back({ pointer, begin, end });
+    }
+
+    /// \brief An incremental structural scanner over JSON text.
+    class Scanner
+    {
+    public:
+        Scanner(DocumentIndex& index, std::size_t maxDepth):
+            _index(index),
+            _maxDepth(maxDepth)
+        {
+        }
+
+        void scan(const char* data, std::size_t size)
+        {
+            for (std::size_t i = 0; i < size; ++i, ++_offset)
+            {
+                if (_inString)
+                {
+                    // Skip ahead over ordinary string characters.
+                    if (!_collectingKey)
+                    {
+                        while (i < size && data[i] != '"' && data[i] != '\\' && !_escape)
+                        {
+                            ++i;
+                            ++_offset;
+                        }
+
+                        if (i == size)
+                            return;
+                    }
+
+                    _string(data[i]);
+                    continue;
+                }
+
+                if (_inScalar)
+                {
+                    // Skip ahead over the rest of the number or literal.
+                    while (i < size && !_isScalarDelimiter(data[i]))
+                    {
+                        ++i;
+                        ++_offset;
+                    }
+
+                    if (i == size)
+                        return;
+
+                    _inScalar = false;
+                    _endValue(_scalarDepth, _offset);
+                }
+
+                switch (data[i])
+                {
+                    case ' ':
+                    case '\t':
+                    case '\n':
+                    case '\r':
+                        break;
+                    case '{':
+                    case '[':
+                        _beginValue(_offset);
+                        _frames.push_back(Frame());
+                        _frames.back().isObject = (data[i] == '{');
+                        _frames.back().expectingKey = (data[i] == '{');
+                        if (_frames.size() - 1 <= _maxDepth)
+                            _frames.back().pointer = _open[_frames.size() - 1].pointer;
+                        break;
+                    case '}':
+                    case ']':
+                        if (_frames.empty())
+                            throw std::runtime_error("Unbalanced JSON document.");
+                        _frames.pop_back();
+                        _endValue(_frames.size(), _offset + 1);
+                        break;
+                    case ':':
+                        if (!_frames.empty())
+                            _frames.back().expectingKey = false;
+                        break;
+                    case ',':
+                        if (!_frames.empty())
+                        {
+                            if (_frames.back().isObject)
+                                _frames.back().expectingKey = true;
+                            else
+                                ++_frames.back().index;
+                        }
+                        break;
+                    case '"':
+                        _inString = true;
+                        if (!_frames.empty() && _frames.back().isObject && _frames.back().expectingKey)
+                        {
+                            _collectingKey = true;
+                            _key.clear();
+                            _keyHasEscapes = false;
+                        }
+                        else
+                        {
+                            _beginValue(_offset);
+                        }
+                        break;
+                    default:
+                        _beginValue(_offset);
+                        _inScalar = true;
+                        _scalarDepth = _frames.size();
+                        break;
+                }
+            }
+        }
+
+        void finish()
+        {
+            if (_inScalar)
+            {
+                _inScalar = false;
+                _endValue(_scalarDepth, _offset);
+            }
+
+            if (_inString || !_frames.empty())
+                throw std::runtime_error("Truncated JSON document.");
+        }
+
+    private:
+        struct Frame
+        {
+            bool isObject = false;
+            bool expectingKey = false;
+            std::size_t index = 0;
+            std::string key;
+            std::string pointer;
+        };
+
+        struct OpenValue
+        {
+            std::string pointer;
+            uint64_t begin = 0;
+        };
+
+        static bool _isScalarDelimiter(char c)
+        {
+            return c == ',' || c == ']' || c == '}' || c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        void _string(char c)
+        {
+            if (_escape)
+            {
+                _escape = false;
+            }
+            else if (c == '\\')
+            {
+                _escape = true;
+                _keyHasEscapes = _keyHasEscapes || _collectingKey;
+            }
+            else if (c == '"')
+            {
+                _inString = false;
+
+                if (_collectingKey)
+                {
+                    _collectingKey = false;
+
+                    if (_keyHasEscapes)
+                        _key = nlohmann::json::parse("\"" + _key + "\"").get<std::string>();
+
+                    _frames.back().key = _key;
+                }
+                else
+                {
+                    _endValue(_frames.size(), _offset + 1);
+                }
+
+                return;
+            }
+
+            if (_collectingKey)
+                _key.push_back(c);
+        }
+
+        void _beginValue(uint64_t offset)
+        {
+            const std::size_t depth = _frames.size();
+
+            if (depth > _maxDepth)
+                return;
+
+            if (_open.size() < depth + 1)
+                _open.resize(depth + 1);
+
+            OpenValue& value = _open[depth];
+            value.begin = offset;
+            value.pointer.clear();
+
+            if (depth == 0)
+                return;
+
+            const Frame& parent = _frames.back();
+            value.pointer = parent.pointer + "/";
+
+            if (parent.isObject)
+            {
+                for (char c: parent.key)
+                {
+                    if (c == '~') value.pointer += "~0";
+                    else if (c == '/') value.pointer += "~1";
+                    else value.pointer.push_back(c);
+                }
+            }
+            else
+            {
+                value.pointer += std::to_string(parent.index);
+            }
+        }
+
+        void _endValue(std::size_t depth, uint64_t offset)
+        {
+            if (depth == 0 || depth > _maxDepth)
+                return;
+
+            _index._add(_open[depth].pointer, _open[depth].begin, offset);
+        }
+
+        DocumentIndex& _index;
+        std::size_t _maxDepth = 1;
+        uint64_t _offset = 0;
+
+        /// \brief The enclosing containers.
+        std::vector<Frame> _frames;
+
+        /// \brief The value currently open at each indexed depth.
+        std::vector<OpenValue> _open;
+
+        bool _inString = false;
+        bool _escape = false;
+        bool _collectingKey = false;
+        bool _keyHasEscapes = false;
+        std::string _key;
+
+        bool _inScalar = false;
+        std::size_t _scalarDepth = 0;
+
+    };
+
+    /// \brief The stamp of the indexed document.
+    FileStamp _source;
+
+    /// \brief The maximum depth of indexed values.
+    std::size_t _maxDepth = 1;
+
+    /// \brief The entries in document order.
+    std::vector<Entry> _entries;
+
+    /// \brief The entry index of each JSON pointer.
+    std::unordered_map<std::string, std::size_t> _lookup;
+
+};
+
+
+/// \brief A JSON document whose values are parsed on demand.
+///
+/// Uses a DocumentIndex persisted next to the document so that only the
+/// requested values are read and parsed.
+class IndexedDocument
+{
+public:
+    /// \brief Open a document, loading or building its index.
+    /// \param filename The JSON document.
+    /// \param maxDepth The maximum depth of indexed values, as in
+    ///        DocumentIndex::build().
+    IndexedDocument(const std::string& filename, std::size_t maxDepth = 1):
+        _path(ofToDataPath(filename, true)),
+        _index(DocumentIndex::load(filename, maxDepth))
+    {
+    }
+
+    /// \brief Read the text of an indexed value.
+    ///
+    /// This is safe to call from multiple threads.
+    ///
+    /// \param entry The indexed value.
+    /// \returns the text of the value.
+    std::string read(const DocumentIndex::Entry& entry) const
+    {
+        std::ifstream stream(_path, std::ios::binary);
+        stream.seekg(std::streamoff(entry.begin));
+
+        std::string text(std::size_t(entry.end - entry.begin), '\0');
+
+        if (!stream.read(&text[0], std::streamsize(text.size())))
+            throw std::runtime_error("Unable to read " + entry.pointer + " from " + _path);
+
+        return text;
+    }
+
+    /// \brief Parse an indexed value.
+    /// \param pointer The JSON pointer of the value.
+    /// \returns the parsed value.
+    /// \throws std::out_of_range if the value is not indexed.
+    nlohmann::json parse(const std::string& pointer) const
+    {
+        const DocumentIndex::Entry* entry = _index.find(pointer);
+
+        if (!entry)
+            throw std::out_of_range("No indexed value at " + pointer);
+
+        return nlohmann::json::parse(read(*entry));
+    }
+
+    /// \brief Parse an indexed value and convert it with its from_json() overload.
+    /// \param pointer The JSON pointer of the value.
+    /// \returns the converted value.
+    template<typename T>
+    T get(const std::string& pointer) const
+    {
+        return parse(pointer).get<T>();
+    }
+
+    /// \returns the document index.
+    const DocumentIndex& index() const
+    {
+        return _index;
+    }
+
+private:
+    /// \brief The absolute path of the document.
+    std::string _path;
+
+    /// \brief The document index.
+    DocumentIndex _index;
+
+};
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_DOCUMENT_INDEX_H
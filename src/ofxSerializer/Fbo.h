@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_FBO_H
+#define OF_SERIALIZER_FBO_H
+
+
+#include "json.hpp"
+#include "ofxSerializer/Log.h"
+#include "ofFbo.h"
+
+
+inline void to_json(nlohmann::json& j, const ofFboSettings& v)
+{
+    j["size"]["width"] = v.width;
+    j["size"]["height"] = v.height;
+    j["num_color_buffers"] = v.numColorbuffers;
+    j["color_formats"] = v.colorFormats;
+    j["use_depth"] = v.useDepth;
+    j["use_stencil"] = v.useStencil;
+    j["depth_stencil_as_texture"] = v.depthStencilAsTexture;
+    j["texture_target"] = v.textureTarget;
+    j["internal_format"] = v.internalformat;
+    j["depth_stencil_internal_format"] = v.depthStencilInternalFormat;
+    j["wrap_mode_horizontal"] = v.wrapModeHorizontal;
+    j["wrap_mode_vertical"] = v.wrapModeVertical;
+    j["min_filter"] = v.minFilter;
+    j["max_filter"] = v.maxFilter;
+    j["num_samples"] = v.numSamples;
+}
+
+
+inline void from_json(const nlohmann::json& j, ofFboSettings& v)
+{
+    if (j.count("size"))
+    {
+        int w = j["size"].value("width", 0);
+        int h = j["size"].value("height", 0);
+
+        if (w > 0 && h > 0)
+        {
+            v.width = w;
+            v.height = h;
+        }
+        else
+        {
+            ofLogWarning("from_json") << "Invalid width and/or height: " << w << ", " << h;
+        }
+    }
+
+    v.numColorbuffers = j.value("num_color_buffers", 1);
+    v.colorFormats = j.value("color_formats", std::vector<GLint>());
+    v.useDepth = j.value("use_depth", false);
+    v.useStencil = j.value("use_stencil", false);
+    v.depthStencilAsTexture = j.value("depth_stencil_as_texture", false);
+    v.textureTarget =
+#ifndef TARGET_OPENGLES
+    v.textureTarget = j.value("texture_target", ofGetUsingArbTex() ? GL_TEXTURE_RECTANGLE_ARB : GL_TEXTURE_2D);
+#else
+    v.textureTarget = j.value("texture_target", GL_TEXTURE_2D);
+#endif
+    v.internalformat = j.value("internal_format", GL_RGBA);
+    v.depthStencilInternalFormat = j.value("depth_stencil_internal_format", GL_DEPTH_COMPONENT24);
+    v.wrapModeHorizontal = j.value("wrap_mode_horizontal", GL_CLAMP_TO_EDGE);
+    v.wrapModeVertical = j.value("wrap_mode_vertical", GL_CLAMP_TO_EDGE);
+    v.minFilter = j.value("min_filter", GL_LINEAR);
+    v.maxFilter = j.value("max_filter", GL_LINEAR);
+    v.numSamples = j.value("num_samples", 0);
+}
+
+
+#endif // OF_SERIALIZER_FBO_H
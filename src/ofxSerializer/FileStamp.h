@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_FILE_STAMP_H
+#define OF_SERIALIZER_FILE_STAMP_H
+
+
+#include <cstdint>
+#include <string>
+#include <sys/stat.h>
+#include "json.hpp"
+#include "ofConstants.h"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief The size and modification time of a file.
+///
+/// Used to decide whether a derived file (an index or a cache) is still
+/// fresh with respect to its source.
+struct FileStamp
+{
+    /// \brief True if the file exists.
+    bool exists = false;
+
+    /// \brief The file size in bytes.
+    uint64_t size = 0;
+
+    /// \brief The modification time in seconds since the epoch.
+    int64_t modified = 0;
+
+    bool operator == (const FileStamp& other) const
+    {
+        return exists == other.exists
+            && size == other.size
+            && modified == other.modified;
+    }
+
+    bool operator != (const FileStamp& other) const
+    {
+        return !(*this == other);
+    }
+
+    /// \brief Get the stamp of a file.
+    /// \param path The absolute path of the file.
+    /// \returns the file's stamp, with exists set to false if it was not found.
+    static FileStamp fromFile(const std::string& path)
+    {
+        FileStamp stamp;
+
+#if defined(TARGET_WIN32)
+        struct _stat64 info;
+        if (::_stat64(path.c_str(), &info) == 0)
+#else
+        struct stat info;
+        if (::stat(path.c_str(), &info) == 0)
+#endif
+        {
+            stamp.exists = true;
+            stamp.size = uint64_t(info.st_size);
+            stamp.modified = int64_t(info.st_mtime);
+        }
+
+        return stamp;
+    }
+};
+
+
+inline void to_json(nlohmann::json& j, const FileStamp& v)
+{
+    j = { { "size", v.size }, { "modified", v.modified } };
+}
+
+
+inline void from_json(const nlohmann::json& j, FileStamp& v)
+{
+    v.exists = true;
+    v.size = j.value("size", uint64_t(0));
+    v.modified = j.value("modified", int64_t(0));
+}
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_FILE_STAMP_H
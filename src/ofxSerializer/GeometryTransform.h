@@ -0,0 +1,341 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_GEOMETRY_TRANSFORM_H
+#define OF_SERIALIZER_GEOMETRY_TRANSFORM_H
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "ofxSerializer/Glm.h"
+#include "ofxSerializer/Color.h"
+#include "ofxSerializer/Mesh.h"
+#include "ofxSerializer/Polyline.h"
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+#include "glm/gtc/matrix_inverse.hpp"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief A transform applied to geometry while it is loaded.
+struct GeometryTransform
+{
+    /// \brief The affine transform applied to vertices.
+    glm::mat4 matrix = glm::mat4(1);
+
+    /// \brief Transform normals by the inverse transpose of the matrix.
+    bool transformNormals = true;
+
+    /// \brief Normalize normals after transforming them.
+    bool normalizeNormals = true;
+
+    /// \brief The scale applied to color components, e.g. 1 / 255.0 to load
+    ///        the colors of an ofMesh saved with ofColor into ofFloatColor.
+    float colorScale = 1;
+};
+
+
+/// \brief The axis-aligned bounds of loaded geometry.
+struct GeometryBounds
+{
+    glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+
+    /// \returns true if no vertex was added.
+    bool isEmpty() const
+    {
+        return min.x > max.x;
+    }
+
+    /// \brief Grow the bounds to include a point.
+    void add(const glm::vec3& point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    /// \brief Grow the bounds to include other bounds.
+    void add(const GeometryBounds& bounds)
+    {
+        min = glm::min(min, bounds.min);
+        max = glm::max(max, bounds.max);
+    }
+};
+
+
+/// \brief Loads serialized geometry and transforms it in the same pass.
+///
+/// Values are decoded in chunks small enough to stay in cache, and each chunk
+/// is transformed right after it is decoded rather than in a second pass over
+/// the whole mesh. The matrix products use glm, and so use SIMD where glm is
+/// configured to.
+class GeometryTransformer
+{
+public:
+    /// \brief The number of values decoded before they are transformed.
+    enum
+    {
+        CHUNK_SIZE = 1024
+    };
+
+    /// \brief Create a transformer.
+    /// \param transform The transform to apply.
+    GeometryTransformer(const GeometryTransform& transform = GeometryTransform()):
+        _transform(transform),
+        _normalMatrix(glm::inverseTranspose(glm::mat3(transform.matrix))),
+        _identity(transform.matrix == glm::mat4(1))
+    {
+    }
+
+    /// \brief Decode and transform vertices.
+    /// \param values The serialized vertices.
+    /// \param vertices The vertices to fill.
+    /// \param bounds The bounds to grow by the transformed vertices.
+    template<typename VertexType>
+    void vertices(const nlohmann::json& values,
+                  std::vector<VertexType>& vertices,
+                  GeometryBounds& bounds) const
+    {
+        _decode(values, vertices, [&](VertexType* begin, VertexType* end)
+        {
+            GeometryBounds chunk;
+
+            for (VertexType* vertex = begin; vertex != end; ++vertex)
+            {
+                if (!_identity)
+                    *vertex = VertexType(_transform.matrix * glm::vec4(*vertex, 1));
+
+                chunk.add(*vertex);
+            }
+
+            bounds.add(chunk);
+        });
+    }
+
+    /// \brief Decode and transform normals.
+    /// \param values The serialized normals.
+    /// \param normals The normals to fill.
+    template<typename NormalType>
+    void normals(const nlohmann::json& values, std::vector<NormalType>& normals) const
+    {
+        const bool transform = _transform.transformNormals && !_identity;
+
+        _decode(values, normals, [&](NormalType* begin, NormalType* end)
+        {
+            if (!transform && !_transform.normalizeNormals)
+                return;
+
+            for (NormalType* normal = begin; normal != end; ++normal)
+            {
+                if (transform)
+                    *normal = _normalMatrix * *normal;
+
+                if (_transform.normalizeNormals && glm::dot(*normal, *normal) > 0)
+                    *normal = glm::normalize(*normal);
+            }
+        });
+    }
+
+    /// \brief Decode and scale colors.
+    ///
+    /// Components are scaled as floats, then rounded and clamped for integer
+    /// color types. Missing components default to the limit of the color type.
+    ///
+    /// \param values The serialized colors.
+    /// \param colors The colors to fill.
+    template<typename PixelType>
+    void colors(const nlohmann::json& values, std::vector<ofColor_<PixelType>>& colors) const
+    {
+        const float scale = _transform.colorScale;
+        const float limit = float(ofColor_<PixelType>::limit());
+
+        colors.resize(values.size());
+
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            float rgba[4] = { limit, limit, limit, limit };
+            const nlohmann::json& color = values[i];
+
+            for (auto iter = color.begin(); iter != color.end(); ++iter)
+            {
+                const std::string& key = iter.key();
+
+                if (key.size() != 1)
+                    continue;
+
+                const int component = key[0] == 'r' ? 0 : key[0] == 'g' ? 1 : key[0] == 'b' ? 2 : key[0] == 'a' ? 3 : -1;
+
+                if (component < 0)
+                    continue;
+
+                float value = iter.value().template get<float>() * scale;
+
+                if (std::numeric_limits<PixelType>::is_integer)
+                    value = std::round(std::min(std::max(value, 0.0f), limit));
+
+                rgba[component] = value;
+            }
+
+            colors[i].set(PixelType(rgba[0]), PixelType(rgba[1]), PixelType(rgba[2]), PixelType(rgba[3]));
+        }
+    }
+
+    /// \brief Decode texture coordinates.
+    /// \param values The serialized texture coordinates.
+    /// \param texCoords The texture coordinates to fill.
+    template<typename TexCoordType>
+    void texCoords(const nlohmann::json& values, std::vector<TexCoordType>& texCoords) const
+    {
+        _decode(values, texCoords, [](TexCoordType*, TexCoordType*) {});
+    }
+
+    /// \returns the transform.
+    const GeometryTransform& transform() const
+    {
+        return _transform;
+    }
+
+private:
+    template<typename Type, typename Function>
+    static void _decode(const nlohmann::json& values, std::vector<Type>& output, Function&& function)
+    {
+        const std::size_t count = values.size();
+        output.resize(count);
+
+        for (std::size_t begin = 0; begin < count; begin += CHUNK_SIZE)
+        {
+            const std::size_t end = std::min(count, begin + CHUNK_SIZE);
+
+            for (std::size_t i = begin; i < end; ++i)
+                _read(values[i], output[i]);
+
+            function(output.data() + begin, output.data() + end);
+        }
+    }
+
+    /// \brief Read a vector with one pass over its members, rather than a
+    ///        lookup for each component as from_json() does.
+    template<typename VectorType>
+    static void _read(const nlohmann::json& j, VectorType& v)
+    {
+        if (!j.is_object())
+        {
+            j.get_to(v);
+            return;
+        }
+
+        v = VectorType(0);
+
+        for (auto iter = j.begin(); iter != j.end(); ++iter)
+        {
+            const std::string& key = iter.key();
+            const unsigned component = unsigned(key[0] - 'x');
+
+            if (key.size() == 1 && component < unsigned(VectorType::length()))
+                v[int(component)] = iter.value().template get<typename VectorType::value_type>();
+        }
+    }
+
+    /// \brief The transform to apply.
+    GeometryTransform _transform;
+
+    /// \brief The inverse transpose of the transform matrix.
+    glm::mat3 _normalMatrix;
+
+    /// \brief True if the matrix is the identity.
+    bool _identity = true;
+
+};
+
+
+/// \brief Deserialize a mesh and transform it in the same pass.
+///
+/// This is equivalent to from_json() followed by transforming every vertex
+/// and normal, converting the colors and computing the bounds, without the
+/// extra passes over the mesh.
+///
+/// \param j The serialized mesh.
+/// \param mesh The mesh to fill.
+/// \param transform The transform to apply.
+/// \returns the bounds of the transformed vertices.
+template<class V, class N, class C, class T>
+GeometryBounds TransformedMeshFromJson(const nlohmann::json& j,
+                                       ofMesh_<V, N, C, T>& mesh,
+                                       const GeometryTransform& transform = GeometryTransform())
+{
+    const GeometryTransformer transformer(transform);
+    const nlohmann::json empty = nlohmann::json::array();
+
+    GeometryBounds bounds;
+
+    mesh = ofMesh_<V, N, C, T>();
+
+    auto iter = j.find("vertices");
+    transformer.vertices(iter != j.end() ? *iter : empty, mesh.getVertices(), bounds);
+
+    iter = j.find("normals");
+    transformer.normals(iter != j.end() ? *iter : empty, mesh.getNormals());
+
+    iter = j.find("colors");
+    transformer.colors(iter != j.end() ? *iter : empty, mesh.getColors());
+
+    iter = j.find("tex_coords");
+    transformer.texCoords(iter != j.end() ? *iter : empty, mesh.getTexCoords());
+
+    mesh.addIndices(j.value("indices", std::vector<ofIndexType>()));
+    mesh.setMode(j.value("primitive_mode", OF_PRIMITIVE_TRIANGLES));
+
+    if (j.value("using_colors", true)) mesh.enableColors();
+    else mesh.disableColors();
+
+    if (j.value("using_textures", true)) mesh.enableTextures();
+    else mesh.disableTextures();
+
+    if (j.value("using_normals", true)) mesh.enableNormals();
+    else mesh.disableNormals();
+
+    if (j.value("using_indices", true)) mesh.enableIndices();
+    else mesh.disableIndices();
+
+    return bounds;
+}
+
+
+/// \brief Deserialize a polyline and transform it in the same pass.
+/// \param j The serialized polyline.
+/// \param polyline The polyline to fill.
+/// \param transform The transform to apply.
+/// \returns the bounds of the transformed vertices.
+template<typename VertexType>
+GeometryBounds TransformedPolylineFromJson(const nlohmann::json& j,
+                                           ofPolyline_<VertexType>& polyline,
+                                           const GeometryTransform& transform = GeometryTransform())
+{
+    const GeometryTransformer transformer(transform);
+
+    GeometryBounds bounds;
+
+    polyline.clear();
+    transformer.vertices(j.at("vertices"), polyline.getVertices(), bounds);
+    polyline.setClosed(j.value("is_closed", false));
+    polyline.flagHasChanged();
+
+    return bounds;
+}
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_GEOMETRY_TRANSFORM_H
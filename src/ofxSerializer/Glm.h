@@ -0,0 +1,229 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_GLM_H
+#define OF_SERIALIZER_GLM_H
+
+
+#include "json.hpp"
+#include "ofVectorMath.h"
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "glm/mat3x3.hpp"
+#include "glm/mat4x4.hpp"
+
+
+namespace glm
+{
+
+
+template<typename T, glm::precision P>
+void to_json(nlohmann::json& j, const glm::tvec2<T, P>& v)
+{
+    j = { { "x", v.x }, { "y", v.y } };
+}
+
+
+template<typename T, glm::precision P>
+void from_json(const nlohmann::json& j, glm::tvec2<T, P>& v)
+{
+    v.x = j.value("x", typename glm::tvec2<T, P>::value_type(0));
+    v.y = j.value("y", typename glm::tvec2<T, P>::value_type(0));
+}
+
+
+template<typename T, glm::precision P>
+void to_json(nlohmann::json& j, const glm::tvec3<T, P>& v)
+{
+    j = { { "x", v.x }, { "y", v.y }, { "z", v.z } };
+}
+
+
+template<typename T, glm::precision P>
+void from_json(const nlohmann::json& j, glm::tvec3<T, P>& v)
+{
+    v.x = j.value("x", typename glm::tvec3<T, P>::value_type(0));
+    v.y = j.value("y", typename glm::tvec3<T, P>::value_type(0));
+    v.z = j.value("z", typename glm::tvec3<T, P>::value_type(0));
+}
+
+
+template<typename T, glm::precision P>
+void to_json(nlohmann::json& j, const glm::tvec4<T, P>& v)
+{
+    j = { { "x", v.x }, { "y", v.y }, { "z", v.z }, { "w", v.w } };
+}
+
+
+template<typename T, glm::precision P>
+void from_json(const nlohmann::json& j, glm::tvec4<T, P>& v)
+{
+    v.x = j.value("x", typename glm::tvec3<T, P>::value_type(0));
+    v.y = j.value("y", typename glm::tvec3<T, P>::value_type(0));
+    v.z = j.value("z", typename glm::tvec3<T, P>::value_type(0));
+    v.w = j.value("w", typename glm::tvec3<T, P>::value_type(1));
+}
+
+
+template<typename T, glm::precision P>
+void to_json(nlohmann::json& j, const glm::tmat3x3<T, P>& v)
+{
+    j = { v[0], v[1], v[2] };
+}
+
+
+template<typename T, glm::precision P>
+void from_json(const nlohmann::json& j, glm::tmat3x3<T, P>& v)
+{
+    v[0] = j[0];
+    v[1] = j[1];
+    v[2] = j[2];
+}
+
+
+template<typename T, glm::precision P>
+void to_json(nlohmann::json& j, const glm::tmat4x4<T, P>& v)
+{
+    j = { v[0], v[1], v[2], v[3] };
+}
+
+
+template<typename T, glm::precision P>
+void from_json(const nlohmann::json& j, glm::tmat4x4<T, P>& v)
+{
+    v[0] = j[0];
+    v[1] = j[1];
+    v[2] = j[2];
+    v[3] = j[3];
+}
+
+
+template<typename T, glm::precision P>
+void to_json(nlohmann::json& j, const glm::tquat<T, P>& v)
+{
+    j = { { "x", v.x }, { "y", v.y }, { "z", v.z }, { "w", v.w } };
+}
+
+
+template<typename T, glm::precision P>
+void from_json(const nlohmann::json& j, glm::tquat<T, P>& v)
+{
+    v.x = j.value("x", typename glm::tquat<T, P>::value_type(1));
+    v.y = j.value("y", typename glm::tquat<T, P>::value_type(0));
+    v.z = j.value("z", typename glm::tquat<T, P>::value_type(0));
+    v.w = j.value("w", typename glm::tquat<T, P>::value_type(0));
+}
+
+
+}; // namespace glm
+
+
+inline void to_json(nlohmann::json& j, const ofVec2f& v)
+{
+    to_json(j, toGlm(v));
+}
+
+
+inline void from_json(const nlohmann::json& j, ofVec2f& v)
+{
+    glm::vec2 g;
+    from_json(j, g);
+    v = toOf(g);
+}
+
+
+inline void to_json(nlohmann::json& j, const ofVec3f& v)
+{
+    to_json(j, toGlm(v));
+}
+
+
+inline void from_json(const nlohmann::json& j, ofVec3f& v)
+{
+    glm::vec3 g;
+    from_json(j, g);
+    v = toOf(g);
+}
+
+
+inline void to_json(nlohmann::json& j, const ofVec4f& v)
+{
+    to_json(j, toGlm(v));
+}
+
+
+inline void from_json(const nlohmann::json& j, ofVec4f& v)
+{
+    glm::vec4 g;
+    from_json(j, g);
+    v = toOf(g);
+}
+
+
+inline void to_json(nlohmann::json& j, const ofMatrix3x3& v)
+{
+    to_json(j, toGlm(v));
+}
+
+
+inline void from_json(const nlohmann::json& j, ofMatrix3x3& v)
+{
+    glm::mat3 g;
+    from_json(j, g);
+    v = toOf(g);
+}
+
+
+inline void to_json(nlohmann::json& j, const ofMatrix4x4& v)
+{
+    to_json(j, toGlm(v));
+}
+
+
+inline void from_json(const nlohmann::json& j, ofMatrix4x4& v)
+{
+    glm::mat4 g;
+    from_json(j, g);
+    v = toOf(g);
+}
+
+
+inline void to_json(nlohmann::json& j, const ofQuaternion& v)
+{
+    to_json(j, toGlm(v));
+}
+
+
+inline void from_json(const nlohmann::json& j, ofQuaternion& v)
+{
+    glm::quat g;
+    from_json(j, g);
+    v = ofQuaternion(g);
+}
+
+
+#ifndef OF_SERIALIZER_NO_EXTERN_TEMPLATES
+
+namespace glm
+{
+
+
+extern template void to_json(nlohmann::json& j, const glm::vec2& v);
+extern template void from_json(const nlohmann::json& j, glm::vec2& v);
+extern template void to_json(nlohmann::json& j, const glm::vec3& v);
+extern template void from_json(const nlohmann::json& j, glm::vec3& v);
+extern template void to_json(nlohmann::json& j, const glm::vec4& v);
+extern template void from_json(const nlohmann::json& j, glm::vec4& v);
+
+
+} // namespace glm
+
+#endif
+
+
+#endif // OF_SERIALIZER_GLM_H
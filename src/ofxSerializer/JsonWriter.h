@@ -0,0 +1,418 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_JSON_WRITER_H
+#define OF_SERIALIZER_JSON_WRITER_H
+
+
+#include <algorithm>
+#include <cfloat>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+#include "json.hpp"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief Writes JSON text with short float numbers.
+///
+/// nlohmann::json stores every float as a double, so j.dump() prints 0.1f as
+/// 0.10000000149011612. This writer prints every number that is exactly
+/// representable as a float with the shortest decimal that reads back as the
+/// same float, e.g. 0.1. Reading the text and converting the numbers to float
+/// gives bit-identical values. Other numbers are printed as j.dump() does.
+///
+/// The shortest decimal comes from the Grisu2 implementation nlohmann::json
+/// uses for doubles, specialized for float.
+///
+/// A double that happens to be exactly representable as a float is printed
+/// as a float too, so it reads back as a nearby double. Use j.dump() for
+/// documents that need exact doubles.
+///
+/// Apart from the numbers, the output matches j.dump(indent), except that
+/// strings are not validated as UTF-8.
+class JsonWriter
+{
+public:
+    /// \brief Create a writer.
+    /// \param indent The indentation, or -1 for compact output.
+    JsonWriter(int indent = -1): _indent(indent)
+    {
+    }
+
+    /// \brief Append a document to a string.
+    /// \param output The string to append to.
+    /// \param j The document to write.
+    void write(std::string& output, const nlohmann::json& j) const
+    {
+        _write(output, j, 0);
+    }
+
+    /// \brief Append a number to a string.
+    ///
+    /// Finite doubles that are exactly representable as a float are printed
+    /// as the shortest float, others as the shortest double. Non-finite
+    /// numbers are printed as null.
+    ///
+    /// \param output The string to append to.
+    /// \param value The number to write.
+    static void writeNumber(std::string& output, double value)
+    {
+        char buffer[64];
+
+        if (!std::isfinite(value))
+        {
+            output += "null";
+            return;
+        }
+
+        // Converting a double outside the float range is undefined.
+        if (std::fabs(value) <= FLT_MAX && double(float(value)) == value)
+        {
+            char* end = _floatToChars(buffer, buffer + sizeof(buffer), float(value));
+
+            if (_readsBackAs(buffer, end, float(value)))
+            {
+                output.append(buffer, end);
+                return;
+            }
+        }
+
+        output.append(buffer, nlohmann::detail::to_chars(buffer, buffer + sizeof(buffer), value));
+    }
+
+private:
+    void _write(std::string& output, const nlohmann::json& j, int level) const
+    {
+        switch (j.type())
+        {
+            case nlohmann::json::value_t::object:
+            {
+                if (j.empty())
+                {
+                    output += "{}";
+                    return;
+                }
+
+                output += '{';
+                bool first = true;
+
+                for (auto iter = j.begin(); iter != j.end(); ++iter)
+                {
+                    if (!first)
+                        output += ',';
+
+                    first = false;
+                    _newline(output, level + 1);
+                    _writeString(output, iter.key());
+                    output += _indent >= 0 ? ": " : ":";
+                    _write(output, iter.value(), level + 1);
+                }
+
+                _newline(output, level);
+                output += '}';
+                return;
+            }
+            case nlohmann::json::value_t::array:
+            {
+                if (j.empty())
+                {
+                    output += "[]";
+                    return;
+                }
+
+                output += '[';
+                bool first = true;
+
+                for (const auto& value: j)
+                {
+                    if (!first)
+                        output += ',';
+
+                    first = false;
+                    _newline(output, level + 1);
+                    _write(output, value, level + 1);
+                }
+
+                _newline(output, level);
+                output += ']';
+                return;
+            }
+            case nlohmann::json::value_t::string:
+                _writeString(output, j.get_ref<const std::string&>());
+                return;
+            case nlohmann::json::value_t::boolean:
+                output += j.get<bool>() ? "true" : "false";
+                return;
+            case nlohmann::json::value_t::number_integer:
+            {
+                const int64_t value = j.get<int64_t>();
+
+                if (value < 0)
+                {
+                    output += '-';
+                    _writeUnsigned(output, 0 - uint64_t(value));
+                }
+                else
+                {
+                    _writeUnsigned(output, uint64_t(value));
+                }
+
+                return;
+            }
+            case nlohmann::json::value_t::number_unsigned:
+                _writeUnsigned(output, j.get<uint64_t>());
+                return;
+            case nlohmann::json::value_t::number_float:
+                writeNumber(output, j.get<double>());
+                return;
+            case nlohmann::json::value_t::binary:
+            {
+                const auto& binary = j.get_binary();
+
+                output += '{';
+                _newline(output, level + 1);
+                output += _indent >= 0 ? "\"bytes\": [" : "\"bytes\":[";
+
+                for (std::size_t i = 0; i < binary.size(); ++i)
+                {
+                    if (i > 0)
+                        output += _indent >= 0 ? ", " : ",";
+
+                    _writeUnsigned(output, binary[i]);
+                }
+
+                output += "],";
+                _newline(output, level + 1);
+                output += _indent >= 0 ? "\"subtype\": " : "\"subtype\":";
+
+                if (binary.has_subtype())
+                    _writeUnsigned(output, binary.subtype());
+                else
+                    output += "null";
+
+                _newline(output, level);
+                output += '}';
+                return;
+            }
+            case nlohmann::json::value_t::discarded:
+                output += "<discarded>";
+                return;
+            case nlohmann::json::value_t::null:
+            default:
+                output += "null";
+                return;
+        }
+    }
+
+    /// \brief Write the shortest decimal of a float.
+    ///
+    /// This gives the same output as nlohmann::detail::to_chars(), which
+    /// normalizes the Grisu2 boundaries one bit at a time. The significand of
+    /// a normal float has 24 bits, so here the shifts are constant.
+    static char* _floatToChars(char* first, const char* last, float value)
+    {
+        using nlohmann::detail::dtoa_impl::diyfp;
+
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const uint32_t E = (bits >> 23) & 0xff;
+        const uint64_t F = bits & 0x7fffff;
+
+        // Zero and denormals.
+        if (E == 0)
+            return nlohmann::detail::to_chars(first, last, value);
+
+        if (bits >> 31)
+            *first++ = '-';
+
+        const uint64_t f = F | 0x800000;
+        const int e = int(E) - 150;
+
+        const diyfp v(f << 40, e - 40);
+        const diyfp plus((2 * f + 1) << 39, e - 40);
+        const diyfp minus = (F == 0 && E > 1) ? diyfp((4 * f - 1) << 38, e - 40)
+                                              : diyfp((2 * f - 1) << 39, e - 40);
+
+        int length = 0;
+        int exponent = 0;
+        nlohmann::detail::dtoa_impl::grisu2(first, length, exponent, minus, v, plus);
+
+        return nlohmann::detail::dtoa_impl::format_buffer(first, length, exponent, -4, std::numeric_limits<float>::digits10);
+    }
+
+    /// \brief Check that a float's decimal reads back as the float.
+    ///
+    /// JSON parsers read the decimal as a double and then convert it to a
+    /// float, rounding twice. For a few floats, e.g. 7.038531e-26f, this gives
+    /// the adjacent float, so those are written as doubles instead.
+    static bool _readsBackAs(const char* begin, const char* end, float value)
+    {
+        static const double powers[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        const char* c = begin;
+        const bool negative = *c == '-';
+
+        if (negative)
+            ++c;
+
+        uint64_t digits = 0;
+        int exponent = 0;
+        bool fraction = false;
+
+        for (; c != end && *c != 'e'; ++c)
+        {
+            if (*c == '.')
+            {
+                fraction = true;
+            }
+            else
+            {
+                digits = digits * 10 + uint64_t(*c - '0');
+
+                if (fraction)
+                    --exponent;
+            }
+        }
+
+        if (c != end)
+            exponent += std::atoi(c + 1);
+
+        // A float has at most 9 significant digits, so the digits are exact
+        // in a double and with an exact power of ten the double is correctly
+        // rounded, as a parser would read it.
+        if (exponent >= -22 && exponent <= 22)
+        {
+            double parsed = exponent < 0 ? double(digits) / powers[-exponent] : double(digits) * powers[exponent];
+            return float(negative ? -parsed : parsed) == value;
+        }
+
+        // Otherwise parse the way nlohmann::json does, with the locale's
+        // decimal point.
+        const struct lconv* locale = std::localeconv();
+        const char point = (locale && locale->decimal_point) ? *locale->decimal_point : '.';
+
+        char text[64];
+        std::size_t size = std::size_t(end - begin);
+        std::replace_copy(begin, end, text, '.', point);
+        text[size] = '\0';
+
+        return float(std::strtod(text, nullptr)) == value;
+    }
+
+    void _newline(std::string& output, int level) const
+    {
+        if (_indent >= 0)
+        {
+            output += '\n';
+            output.append(std::size_t(level * _indent), ' ');
+        }
+    }
+
+    static void _writeUnsigned(std::string& output, uint64_t value)
+    {
+        char buffer[20];
+        char* end = buffer + sizeof(buffer);
+        char* begin = end;
+
+        do
+        {
+            *--begin = char('0' + value % 10);
+            value /= 10;
+        }
+        while (value != 0);
+
+        output.append(begin, end);
+    }
+
+    static void _writeString(std::string& output, const std::string& value)
+    {
+        static const char* hex = "0123456789abcdef";
+
+        output += '"';
+
+        const char* run = value.data();
+        const char* end = run + value.size();
+
+        for (const char* c = run; c != end; ++c)
+        {
+            const uint8_t byte = uint8_t(*c);
+
+            if (byte >= 0x20 && byte != '"' && byte != '\\')
+                continue;
+
+            // Append the unescaped characters before this one in one go.
+            output.append(run, c);
+            run = c + 1;
+
+            switch (byte)
+            {
+                case '"': output += "\\\""; break;
+                case '\\': output += "\\\\"; break;
+                case '\b': output += "\\b"; break;
+                case '\f': output += "\\f"; break;
+                case '\n': output += "\\n"; break;
+                case '\r': output += "\\r"; break;
+                case '\t': output += "\\t"; break;
+                default:
+                    output += "\\u00";
+                    output += hex[byte >> 4];
+                    output += hex[byte & 0xf];
+            }
+        }
+
+        output.append(run, end);
+        output += '"';
+    }
+
+    /// \brief The indentation, or -1 for compact output.
+    int _indent = -1;
+
+};
+
+
+/// \brief Serialize a document to JSON text with short float numbers.
+/// \param j The document to serialize.
+/// \param indent The indentation, or -1 for compact output.
+/// \returns the JSON text.
+/// \sa JsonWriter
+inline std::string DumpJson(const nlohmann::json& j, int indent = -1)
+{
+    std::string output;
+    JsonWriter(indent).write(output, j);
+    return output;
+}
+
+
+/// \brief Write a document to a stream as JSON text with short float numbers.
+/// \param stream The stream to write to.
+/// \param j The document to write.
+/// \param indent The indentation, or -1 for compact output.
+/// \sa JsonWriter
+inline void WriteJson(std::ostream& stream, const nlohmann::json& j, int indent = -1)
+{
+    const std::string output = DumpJson(j, indent);
+    stream.write(output.data(), std::streamsize(output.size()));
+}
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_JSON_WRITER_H
@@ -0,0 +1,26 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_LOG_H
+#define OF_SERIALIZER_LOG_H
+
+
+#include "json.hpp"
+#include "ofLog.h"
+
+
+NLOHMANN_JSON_SERIALIZE_ENUM( ofLogLevel, {
+    { OF_LOG_VERBOSE, "OF_LOG_VERBOSE" },
+    { OF_LOG_NOTICE, "OF_LOG_NOTICE"},
+    { OF_LOG_WARNING, "OF_LOG_WARNING"},
+    { OF_LOG_ERROR, "OF_LOG_ERROR" },
+    { OF_LOG_FATAL_ERROR, "OF_LOG_FATAL_ERROR"},
+    { OF_LOG_SILENT, "OF_LOG_SILENT"}
+})
+
+
+#endif // OF_SERIALIZER_LOG_H
@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_MESH_H
+#define OF_SERIALIZER_MESH_H
+
+
+#include "json.hpp"
+#include "ofxSerializer/Glm.h"
+#include "ofxSerializer/Color.h"
+#include "ofMesh.h"
+
+
+#ifndef TARGET_OPENGLES
+
+NLOHMANN_JSON_SERIALIZE_ENUM( ofPrimitiveMode, {
+    { OF_PRIMITIVE_TRIANGLES, "OF_PRIMITIVE_TRIANGLES" },
+    { OF_PRIMITIVE_TRIANGLE_STRIP, "OF_PRIMITIVE_TRIANGLE_STRIP"},
+    { OF_PRIMITIVE_TRIANGLE_FAN, "OF_PRIMITIVE_TRIANGLE_FAN"},
+    { OF_PRIMITIVE_LINES, "OF_PRIMITIVE_LINES" },
+    { OF_PRIMITIVE_LINE_STRIP, "OF_PRIMITIVE_LINE_STRIP"},
+    { OF_PRIMITIVE_LINE_LOOP, "OF_PRIMITIVE_LINE_LOOP"},
+    { OF_PRIMITIVE_POINTS, "OF_PRIMITIVE_POINTS"},
+
+    { OF_PRIMITIVE_LINES_ADJACENCY, "OF_PRIMITIVE_LINES_ADJACENCY"},
+    { OF_PRIMITIVE_LINE_STRIP_ADJACENCY, "OF_PRIMITIVE_LINE_STRIP_ADJACENCY"},
+    { OF_PRIMITIVE_TRIANGLES_ADJACENCY, "OF_PRIMITIVE_TRIANGLES_ADJACENCY"},
+    { OF_PRIMITIVE_TRIANGLE_STRIP_ADJACENCY, "OF_PRIMITIVE_TRIANGLE_STRIP_ADJACENCY"},
+    { OF_PRIMITIVE_PATCHES, "OF_PRIMITIVE_PATCHES"}
+})
+
+#else
+
+NLOHMANN_JSON_SERIALIZE_ENUM( ofPrimitiveMode, {
+    { OF_PRIMITIVE_TRIANGLES, "OF_PRIMITIVE_TRIANGLES" },
+    { OF_PRIMITIVE_TRIANGLE_STRIP, "OF_PRIMITIVE_TRIANGLE_STRIP"},
+    { OF_PRIMITIVE_TRIANGLE_FAN, "OF_PRIMITIVE_TRIANGLE_FAN"},
+    { OF_PRIMITIVE_LINES, "OF_PRIMITIVE_LINES" },
+    { OF_PRIMITIVE_LINE_STRIP, "OF_PRIMITIVE_LINE_STRIP"},
+    { OF_PRIMITIVE_LINE_LOOP, "OF_PRIMITIVE_LINE_LOOP"},
+    { OF_PRIMITIVE_POINTS, "OF_PRIMITIVE_POINTS"},
+})
+
+#endif
+
+
+//std::vector<V> vertices;
+//std::vector<C> colors;
+//std::vector<N> normals;
+//std::vector<T> texCoords;
+//std::vector<ofIndexType> indices;
+//
+//// this variables are only caches and returned always as const
+//// mutable allows to change them from const methods
+//mutable std::vector<ofMeshFace_<V,N,C,T>> faces;
+//mutable bool bFacesDirty;
+//
+//bool bVertsChanged, bColorsChanged, bNormalsChanged, bTexCoordsChanged,
+//bIndicesChanged;
+//ofPrimitiveMode mode;
+//
+//bool useColors;
+//bool useTextures;
+//bool useNormals;
+//bool useIndices;
+
+
+
+template<class V, class N, class C, class T>
+void to_json(nlohmann::json& j, const ofMesh_<V, N, C, T>& v)
+{
+    j["vertices"] = v.getVertices();
+    j["normals"] = v.getNormals();
+    j["colors"] = v.getColors();
+    j["tex_coords"] = v.getTexCoords();
+
+    j["indices"] = v.getIndices();
+
+    j["using_normals"] = v.usingNormals();
+    j["using_colors"] = v.usingColors();
+    j["using_textures"] = v.usingTextures();
+
+    j["using_indices"] = v.usingIndices();
+
+    j["primitive_mode"] = v.getMode();
+}
+
+
+template<class V, class N, class C, class T>
+void from_json(const nlohmann::json& j, ofMesh_<V, N, C, T>& v)
+{
+    v = ofMesh_<V, N, C, T>();
+    v.addVertices(j.value("vertices", std::vector<V>()));
+    v.addNormals(j.value("normals", std::vector<N>()));
+    v.addColors(j.value("colors", std::vector<C>()));
+    v.addTexCoords(j.value("tex_coords", std::vector<T>()));
+
+    v.addIndices(j.value("indices", std::vector<ofIndexType>()));
+
+    v.setMode(j.value("primitive_mode", OF_PRIMITIVE_TRIANGLES));
+
+    // TODO
+    bool usingColors = j.value("using_colors", true);
+    bool usingTextures = j.value("using_textures", true);
+    bool usingNormals = j.value("using_normals", true);
+    bool usingIndices = j.value("using_indices", true);
+
+    if (j.value("using_colors", true)) v.enableColors();
+    else v.disableColors();
+
+    if (j.value("using_textures", true)) v.enableTextures();
+    else v.disableTextures();
+
+    if (j.value("using_normals", true)) v.enableTextures();
+    else v.disableTextures();
+
+    if (j.value("using_indices", true)) v.enableIndices();
+    else v.disableIndices();
+
+}
+
+
+#ifndef OF_SERIALIZER_NO_EXTERN_TEMPLATES
+
+extern template void to_json(nlohmann::json& j, const ofMesh& v);
+extern template void from_json(const nlohmann::json& j, ofMesh& v);
+
+#endif
+
+
+#endif // OF_SERIALIZER_MESH_H
@@ -0,0 +1,363 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_NODE_H
+#define OF_SERIALIZER_NODE_H
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "json.hpp"
+#include "ofxSerializer/Glm.h"
+#include "glm/gtc/packing.hpp"
+#include "ofNode.h"
+
+
+inline void to_json(nlohmann::json& j, const ofNode& v)
+{
+    j["position"] = v.getPosition();
+    j["orientation"] = v.getOrientationQuat();
+    j["scale"] = v.getScale();
+}
+
+
+inline void from_json(const nlohmann::json& j, ofNode& v)
+{
+    v.setPosition(j.value("position", glm::vec3(0, 0, 0)));
+    v.setOrientation(j.value("orientation", glm::quat(1, 0, 0, 0)));
+    v.setScale(j.value("scale", glm::vec3(1, 1, 1)));
+}
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief Options for serializing ofNode hierarchies.
+struct NodeHierarchyEncoding
+{
+    /// \brief Store float columns as binary values rather than number arrays.
+    ///
+    /// Binary values are compact in CBOR, MessagePack and BSON output. They
+    /// are not preserved by JSON text, so binary columns must be saved in a
+    /// binary DocumentFormat.
+    bool binary = false;
+
+    /// \brief Store positions as binary half floats.
+    ///
+    /// This requires \p binary to be set.
+    bool halfPositions = false;
+
+    /// \brief Store orientations as binary 32-bit "smallest three" quaternions.
+    ///
+    /// This requires \p binary to be set.
+    bool compressOrientations = false;
+};
+
+
+/// \brief Pack a unit quaternion into 32 bits.
+///
+/// The index of the largest component is stored in the top 2 bits and the
+/// remaining three components are quantized to 10 bits each. The largest
+/// component is reconstructed from the unit length constraint.
+///
+/// \param q The unit quaternion to pack.
+/// \returns the packed quaternion.
+inline uint32_t PackQuatSmallestThree(const glm::quat& q)
+{
+    const float components[4] = { q.x, q.y, q.z, q.w };
+
+    std::size_t largest = 0;
+    for (std::size_t i = 1; i < 4; ++i)
+        if (std::abs(components[i]) > std::abs(components[largest]))
+            largest = i;
+
+    // q and -q are the same rotation, so make the largest component positive.
+    const float sign = components[largest] < 0 ? -1.0f : 1.0f;
+    const float range = 0.70710678118f; // 1 / sqrt(2)
+
+    uint32_t packed = uint32_t(largest) << 30;
+    uint32_t shift = 20;
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+
+        float normalized = (glm::clamp(sign * components[i] / range, -1.0f, 1.0f) + 1.0f) * 0.5f;
+        packed |= uint32_t(std::lround(normalized * 1023.0f)) << shift;
+        shift -= 10;
+    }
+
+    return packed;
+}
+
+
+/// \brief Unpack a quaternion packed with PackQuatSmallestThree().
+/// \param packed The packed quaternion.
+/// \returns the unpacked unit quaternion.
+inline glm::quat UnpackQuatSmallestThree(uint32_t packed)
+{
+    const float range = 0.70710678118f; // 1 / sqrt(2)
+    const std::size_t largest = packed >> 30;
+
+    float components[4];
+    float sumOfSquares = 0;
+    uint32_t shift = 20;
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+
+        float normalized = float((packed >> shift) & 0x3FF) / 1023.0f;
+        components[i] = (normalized * 2.0f - 1.0f) * range;
+        sumOfSquares += components[i] * components[i];
+        shift -= 10;
+    }
+
+    components[largest] = std::sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+
+    return glm::quat(components[3], components[0], components[1], components[2]);
+}
+
+
+/// \brief Serialize a node hierarchy as a flat structure of arrays.
+///
+/// Each node is stored by its index in \p nodes. Parents are stored as an
+/// index column, with -1 for nodes whose parent is not in \p nodes. Local
+/// positions, orientations and scales are stored as flat float columns.
+///
+/// \param nodes The nodes to serialize.
+/// \param encoding The column encoding options.
+/// \returns the serialized hierarchy.
+/// \throws std::invalid_argument if a compressed column is requested without
+///         binary encoding.
+inline nlohmann::json NodeHierarchyToJson(const std::vector<const ofNode*>& nodes,
+                                          const NodeHierarchyEncoding& encoding = NodeHierarchyEncoding())
+{
+    if ((encoding.halfPositions || encoding.compressOrientations) && !encoding.binary)
+        throw std::invalid_argument("Compressed node hierarchy columns require binary encoding.");
+
+    const std::size_t count = nodes.size();
+
+    std::unordered_map<const ofNode*, int32_t> indices;
+    indices.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        indices[nodes[i]] = int32_t(i);
+
+    std::vector<int32_t> parents(count, -1);
+    std::vector<float> positions(count * 3);
+    std::vector<float> orientations(count * 4);
+    std::vector<float> scales(count * 3);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const ofNode& node = *nodes[i];
+
+        auto parent = indices.find(node.getParent());
+        if (parent != indices.end())
+            parents[i] = parent->second;
+
+        const glm::vec3 position = node.getPosition();
+        const glm::quat orientation = node.getOrientationQuat();
+        const glm::vec3 scale = node.getScale();
+
+        std::memcpy(&positions[i * 3], &position[0], sizeof(float) * 3);
+        orientations[i * 4 + 0] = orientation.x;
+        orientations[i * 4 + 1] = orientation.y;
+        orientations[i * 4 + 2] = orientation.z;
+        orientations[i * 4 + 3] = orientation.w;
+        std::memcpy(&scales[i * 3], &scale[0], sizeof(float) * 3);
+    }
+
+    auto toBinary = [](const void* data, std::size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        return nlohmann::json::binary(std::vector<uint8_t>(bytes, bytes + size));
+    };
+
+    nlohmann::json j;
+    j["count"] = count;
+    j["parents"] = parents;
+
+    if (encoding.halfPositions)
+    {
+        std::vector<uint16_t> halves(positions.size());
+        for (std::size_t i = 0; i < positions.size(); ++i)
+            halves[i] = glm::packHalf1x16(positions[i]);
+
+        j["position_encoding"] = "half";
+        j["positions"] = toBinary(halves.data(), halves.size() * sizeof(uint16_t));
+    }
+    else if (encoding.binary)
+    {
+        j["position_encoding"] = "float";
+        j["positions"] = toBinary(positions.data(), positions.size() * sizeof(float));
+    }
+    else
+    {
+        j["positions"] = positions;
+    }
+
+    if (encoding.compressOrientations)
+    {
+        std::vector<uint32_t> packed(count);
+        for (std::size_t i = 0; i < count; ++i)
+            packed[i] = PackQuatSmallestThree(nodes[i]->getOrientationQuat());
+
+        j["orientation_encoding"] = "smallest_three";
+        j["orientations"] = toBinary(packed.data(), packed.size() * sizeof(uint32_t));
+    }
+    else if (encoding.binary)
+    {
+        j["orientation_encoding"] = "float";
+        j["orientations"] = toBinary(orientations.data(), orientations.size() * sizeof(float));
+    }
+    else
+    {
+        j["orientations"] = orientations;
+    }
+
+    if (encoding.binary)
+    {
+        j["scale_encoding"] = "float";
+        j["scales"] = toBinary(scales.data(), scales.size() * sizeof(float));
+    }
+    else
+    {
+        j["scales"] = scales;
+    }
+
+    return j;
+}
+
+
+/// \brief Serialize a node hierarchy as a flat structure of arrays.
+/// \param nodes The nodes to serialize.
+/// \param encoding The column encoding options.
+/// \returns the serialized hierarchy.
+/// \throws std::invalid_argument if a compressed column is requested without
+///         binary encoding.
+inline nlohmann::json NodeHierarchyToJson(const std::vector<ofNode>& nodes,
+                                          const NodeHierarchyEncoding& encoding = NodeHierarchyEncoding())
+{
+    std::vector<const ofNode*> pointers(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+        pointers[i] = &nodes[i];
+    return NodeHierarchyToJson(pointers, encoding);
+}
+
+
+/// \brief Read a float column written by NodeHierarchyToJson().
+/// \param j The hierarchy.
+/// \param key The column key.
+/// \param size The expected number of floats.
+/// \returns the column values.
+inline std::vector<float> NodeHierarchyColumn(const nlohmann::json& j,
+                                              const std::string& key,
+                                              std::size_t size)
+{
+    std::vector<float> values(size, 0.0f);
+    const auto& column = j.at(key);
+    const std::string encoding = j.value(key.substr(0, key.size() - 1) + "_encoding", "float");
+
+    if (column.is_binary())
+    {
+        const auto& bytes = column.get_binary();
+
+        if (encoding == "half")
+        {
+            std::size_t n = std::min(size, bytes.size() / sizeof(uint16_t));
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                uint16_t half;
+                std::memcpy(&half, bytes.data() + i * sizeof(uint16_t), sizeof(uint16_t));
+                values[i] = glm::unpackHalf1x16(half);
+            }
+        }
+        else
+        {
+            std::memcpy(values.data(), bytes.data(), std::min(size * sizeof(float), bytes.size()));
+        }
+    }
+    else
+    {
+        std::size_t n = std::min(size, column.size());
+        for (std::size_t i = 0; i < n; ++i)
+            values[i] = column[i].get<float>();
+    }
+
+    return values;
+}
+
+
+/// \brief Deserialize a node hierarchy written by NodeHierarchyToJson().
+///
+/// \p nodes is resized to the number of serialized nodes. Local transforms
+/// are applied and parent links are rebuilt in a single linear pass. The
+/// nodes must not be moved afterwards, as children refer to their parents
+/// by address.
+///
+/// \param j The serialized hierarchy.
+/// \param nodes The nodes to fill.
+inline void NodeHierarchyFromJson(const nlohmann::json& j, std::vector<ofNode>& nodes)
+{
+    const std::size_t count = j.at("count").get<std::size_t>();
+    const std::vector<int32_t> parents = j.at("parents").get<std::vector<int32_t>>();
+
+    const std::vector<float> positions = NodeHierarchyColumn(j, "positions", count * 3);
+    const std::vector<float> scales = NodeHierarchyColumn(j, "scales", count * 3);
+
+    std::vector<glm::quat> orientations(count);
+
+    if (j.value("orientation_encoding", "float") == "smallest_three")
+    {
+        const auto& bytes = j.at("orientations").get_binary();
+        std::size_t n = std::min(count, bytes.size() / sizeof(uint32_t));
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            uint32_t packed;
+            std::memcpy(&packed, bytes.data() + i * sizeof(uint32_t), sizeof(uint32_t));
+            orientations[i] = UnpackQuatSmallestThree(packed);
+        }
+    }
+    else
+    {
+        const std::vector<float> values = NodeHierarchyColumn(j, "orientations", count * 4);
+
+        for (std::size_t i = 0; i < count; ++i)
+            orientations[i] = glm::quat(values[i * 4 + 3], values[i * 4 + 0], values[i * 4 + 1], values[i * 4 + 2]);
+    }
+
+    nodes.clear();
+    nodes.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        ofNode& node = nodes[i];
+        node.setPosition(positions[i * 3 + 0], positions[i * 3 + 1], positions[i * 3 + 2]);
+        node.setOrientation(orientations[i]);
+        node.setScale(scales[i * 3 + 0], scales[i * 3 + 1], scales[i * 3 + 2]);
+
+        if (i < parents.size() && parents[i] >= 0 && std::size_t(parents[i]) < count)
+            node.setParent(nodes[parents[i]], false);
+    }
+}
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_NODE_H
@@ -0,0 +1,230 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_PARALLEL_LOAD_H
+#define OF_SERIALIZER_PARALLEL_LOAD_H
+
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "json.hpp"
+#include "ofxSerializer/DocumentIndex.h"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief The result of loading one top-level value of a document.
+template<typename T>
+struct LoadResult
+{
+    /// \brief The JSON pointer of the value.
+    std::string pointer;
+
+    /// \brief The loaded value, valid if error is empty.
+    T value;
+
+    /// \brief The error raised while loading the value, if any.
+    std::string error;
+
+    /// \returns true if the value was loaded.
+    bool ok() const
+    {
+        return error.empty();
+    }
+};
+
+
+/// \brief Call a function for each index in [0, count) on several threads.
+///
+/// Threads claim the next unprocessed index until none remain, so threads
+/// that finish small items early pick up the remaining work. The calling
+/// thread takes part in the work.
+///
+/// \param count The number of items.
+/// \param threads The number of threads, or 0 to use all hardware threads.
+/// \param function Called with each index. It must not throw.
+template<typename Function>
+void ParallelFor(std::size_t count, std::size_t threads, Function&& function)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    threads = std::min(threads, count);
+
+    std::atomic<std::size_t> next(0);
+
+    auto work = [&]()
+    {
+        std::size_t i;
+        while ((i = next.fetch_add(1, std::memory_order_relaxed)) < count)
+            function(i);
+    };
+
+    std::vector<std::thread> workers;
+
+    for (std::size_t i = 1; i < threads; ++i)
+        workers.emplace_back(work);
+
+    work();
+
+    for (auto& worker: workers)
+        worker.join();
+}
+
+
+/// \brief Load the top-level values of a parsed document in parallel.
+///
+/// Each member of a root object, or each element of a root array, is passed
+/// to \p load on a worker thread. An exception thrown while loading a value
+/// is recorded in its result and does not affect the other values.
+///
+/// \param document The root object or array.
+/// \param load Called as load(const nlohmann::json&) and returns a T.
+/// \param threads The number of threads, or 0 to use all hardware threads.
+/// \returns the results in document order.
+template<typename T, typename Load, typename = typename std::enable_if<!std::is_integral<typename std::decay<Load>::type>::value>::type>
+std::vector<LoadResult<T>> ParallelLoad(const nlohmann::json& document,
+                                        Load&& load,
+                                        std::size_t threads = 0)
+{
+    std::vector<const nlohmann::json*> values;
+    std::vector<LoadResult<T>> results;
+
+    if (document.is_object())
+    {
+        for (auto iter = document.begin(); iter != document.end(); ++iter)
+        {
+            values.push_back(&iter.value());
+            results.emplace_back();
+            results.back().pointer = "/";
+
+            for (char c: iter.key())
+            {
+                if (c == '~') results.back().pointer += "~0";
+                else if (c == '/') results.back().pointer += "~1";
+                else results.back().pointer += c;
+            }
+        }
+    }
+    else if (document.is_array())
+    {
+        for (std::size_t i = 0; i < document.size(); ++i)
+        {
+            values.push_back(&document[i]);
+            results.emplace_back();
+            results.back().pointer = "/" + std::to_string(i);
+        }
+    }
+
+    ParallelFor(values.size(), threads, [&](std::size_t i)
+    {
+        try
+        {
+            results[i].value = load(*values[i]);
+        }
+        catch (const std::exception& exc)
+        {
+            results[i].error = exc.what();
+        }
+        catch (...)
+        {
+            results[i].error = "Unknown error.";
+        }
+    });
+
+    return results;
+}
+
+
+/// \brief Convert the top-level values of a parsed document in parallel.
+///
+/// Each value is converted with its from_json() overload.
+///
+/// \param document The root object or array.
+/// \param threads The number of threads, or 0 to use all hardware threads.
+/// \returns the results in document order.
+template<typename T>
+std::vector<LoadResult<T>> ParallelLoad(const nlohmann::json& document,
+                                        std::size_t threads = 0)
+{
+    return ParallelLoad<T>(document, [](const nlohmann::json& j) { return j.get<T>(); }, threads);
+}
+
+
+/// \brief Parse and load the top-level values of an indexed document in parallel.
+///
+/// Both parsing and loading run on the worker threads, so the document is
+/// never parsed as a whole.
+///
+/// \param document The indexed document.
+/// \param load Called as load(const nlohmann::json&) and returns a T.
+/// \param threads The number of threads, or 0 to use all hardware threads.
+/// \returns the results in document order.
+template<typename T, typename Load, typename = typename std::enable_if<!std::is_integral<typename std::decay<Load>::type>::value>::type>
+std::vector<LoadResult<T>> ParallelLoad(const IndexedDocument& document,
+                                        Load&& load,
+                                        std::size_t threads = 0)
+{
+    std::vector<const DocumentIndex::Entry*> entries;
+
+    for (const auto& entry: document.index().entries())
+    {
+        // Only the top-level values, whose pointers have a single token.
+        if (!entry.pointer.empty() && entry.pointer.find('/', 1) == std::string::npos)
+            entries.push_back(&entry);
+    }
+
+    std::vector<LoadResult<T>> results(entries.size());
+
+    ParallelFor(entries.size(), threads, [&](std::size_t i)
+    {
+        results[i].pointer = entries[i]->pointer;
+
+        try
+        {
+            results[i].value = load(nlohmann::json::parse(document.read(*entries[i])));
+        }
+        catch (const std::exception& exc)
+        {
+            results[i].error = exc.what();
+        }
+        catch (...)
+        {
+            results[i].error = "Unknown error.";
+        }
+    });
+
+    return results;
+}
+
+
+/// \brief Parse and convert the top-level values of an indexed document in parallel.
+///
+/// Each value is converted with its from_json() overload.
+///
+/// \param document The indexed document.
+/// \param threads The number of threads, or 0 to use all hardware threads.
+/// \returns the results in document order.
+template<typename T>
+std::vector<LoadResult<T>> ParallelLoad(const IndexedDocument& document,
+                                        std::size_t threads = 0)
+{
+    return ParallelLoad<T>(document, [](const nlohmann::json& j) { return j.get<T>(); }, threads);
+}
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_PARALLEL_LOAD_H
@@ -0,0 +1,389 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_PARAMETER_H
+#define OF_SERIALIZER_PARAMETER_H
+
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include "json.hpp"
+#include "ofxSerializer/Glm.h"
+#include "ofxSerializer/Rectangle.h"
+#include "ofxSerializer/Color.h"
+#include "ofParameter.h"
+#include "ofLog.h"
+#include "ofFileUtils.h"
+#include "ofUtils.h"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief Serializes ofAbstractParameters by trying each of the listed types.
+///
+/// Parameters whose value type is not listed fall back to the parameter's
+/// toString() / fromString() representation.
+template<typename... Types>
+struct ParameterSerializer;
+
+
+template<>
+struct ParameterSerializer<>
+{
+    static bool toJson(nlohmann::json&, const ofAbstractParameter&)
+    {
+        return false;
+    }
+
+    static bool fromJson(const nlohmann::json&, ofAbstractParameter&)
+    {
+        return false;
+    }
+};
+
+
+template<typename Type, typename... Types>
+struct ParameterSerializer<Type, Types...>
+{
+    static bool toJson(nlohmann::json& j, const ofAbstractParameter& p)
+    {
+        if (auto typed = dynamic_cast<const ofParameter<Type>*>(&p))
+        {
+            j = typed->get();
+            return true;
+        }
+
+        return ParameterSerializer<Types...>::toJson(j, p);
+    }
+
+    static bool fromJson(const nlohmann::json& j, ofAbstractParameter& p)
+    {
+        if (auto typed = dynamic_cast<ofParameter<Type>*>(&p))
+        {
+            typed->set(j.get<Type>());
+            return true;
+        }
+
+        return ParameterSerializer<Types...>::fromJson(j, p);
+    }
+};
+
+
+/// \brief The parameter value types handled by ParameterToJson / ParameterFromJson.
+///
+/// Enum types are not listed, as ofParameter requires its value type to be
+/// readable from a stream.
+typedef ParameterSerializer<bool,
+                            int,
+                            unsigned int,
+                            int64_t,
+                            uint64_t,
+                            float,
+                            double,
+                            std::string,
+                            glm::vec2,
+                            glm::vec3,
+                            glm::vec4,
+                            ofVec2f,
+                            ofVec3f,
+                            ofVec4f,
+                            ofColor,
+                            ofShortColor,
+                            ofFloatColor,
+                            ofRectangle> DefaultParameterSerializer;
+
+
+/// \brief Serialize a parameter or a parameter group.
+///
+/// Groups are serialized as objects keyed by each child's escaped name.
+///
+/// \param parameter The parameter to serialize.
+/// \returns the serialized parameter.
+inline nlohmann::json ParameterToJson(const ofAbstractParameter& parameter)
+{
+    nlohmann::json j;
+
+    if (auto group = dynamic_cast<const ofParameterGroup*>(&parameter))
+    {
+        j = nlohmann::json::object();
+
+        for (const auto& child: *group)
+        {
+            if (child->isSerializable())
+                j[child->getEscapedName()] = ParameterToJson(*child);
+        }
+    }
+    else if (!DefaultParameterSerializer::toJson(j, parameter))
+    {
+        j = parameter.toString();
+    }
+
+    return j;
+}
+
+
+/// \brief Deserialize a parameter or a parameter group in place.
+///
+/// Members of \p j that do not match a child of a group are ignored, and
+/// children missing from \p j are left unchanged.
+///
+/// \param j The serialized parameter.
+/// \param parameter The parameter to update.
+inline void ParameterFromJson(const nlohmann::json& j, ofAbstractParameter& parameter)
+{
+    if (auto group = dynamic_cast<ofParameterGroup*>(&parameter))
+    {
+        for (auto& child: *group)
+        {
+            auto iter = j.find(child->getEscapedName());
+
+            if (iter != j.end() && child->isSerializable())
+                ParameterFromJson(*iter, *child);
+        }
+    }
+    else if (!DefaultParameterSerializer::fromJson(j, parameter))
+    {
+        if (j.is_string())
+            parameter.fromString(j.get<std::string>());
+        else
+            parameter.fromString(j.dump());
+    }
+}
+
+
+} } // namespace ofx::Serializer
+
+
+template<typename ParameterType>
+inline void to_json(nlohmann::json& j, const ofParameter<ParameterType>& v)
+{
+    j = v.get();
+}
+
+
+template<typename ParameterType>
+inline void from_json(const nlohmann::json& j, ofParameter<ParameterType>& v)
+{
+    v.set(j.get<ParameterType>());
+}
+
+
+inline void to_json(nlohmann::json& j, const ofParameterGroup& v)
+{
+    j = ofx::Serializer::ParameterToJson(v);
+}
+
+
+inline void from_json(const nlohmann::json& j, ofParameterGroup& v)
+{
+    ofx::Serializer::ParameterFromJson(j, v);
+}
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief Persists an ofParameterGroup to a file as its parameters change.
+///
+/// Change events are coalesced. Each changed parameter is serialized once on
+/// the thread that changed it, and only the dirty values are merged into the
+/// cached document, which is written to disk on a background thread at most
+/// once per coalescing window.
+class ParameterPersister
+{
+public:
+    /// \brief Create a persister for a parameter group.
+    /// \param group The group to persist. Its current state is the initial document.
+    /// \param filename The file to write.
+    /// \param window The coalescing window.
+    ParameterPersister(ofParameterGroup& group,
+                       const std::string& filename,
+                       std::chrono::milliseconds window = std::chrono::milliseconds(500)):
+        _group(group),
+        _path(ofToDataPath(filename, true)),
+        _window(window),
+        _document(ParameterToJson(group))
+    {
+        auto hierarchy = _group.getGroupHierarchyNames();
+        _depth = hierarchy.size();
+        _listener = _group.parameterChangedE().newListener(this, &ParameterPersister::_onParameterChanged);
+        _thread = std::thread(&ParameterPersister::_run, this);
+    }
+
+    ParameterPersister(const ParameterPersister&) = delete;
+    ParameterPersister& operator = (const ParameterPersister&) = delete;
+
+    /// \brief Flush pending changes and stop the writer thread.
+    ~ParameterPersister()
+    {
+        _listener.unsubscribe();
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _running = false;
+        }
+
+        _condition.notify_all();
+        _thread.join();
+    }
+
+    /// \brief Write pending changes without waiting for the coalescing window.
+    void flush()
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _flushRequested = true;
+        }
+
+        _condition.notify_all();
+    }
+
+private:
+    void _onParameterChanged(ofAbstractParameter& parameter)
+    {
+        auto hierarchy = parameter.getGroupHierarchyNames();
+
+        std::string pointer;
+        for (std::size_t i = _depth; i < hierarchy.size(); ++i)
+        {
+            pointer += "/";
+
+            for (char c: hierarchy[i])
+            {
+                if (c == '~') pointer += "~0";
+                else if (c == '/') pointer += "~1";
+                else pointer += c;
+            }
+        }
+
+        nlohmann::json value = ParameterToJson(parameter);
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            if (_dirty.empty())
+                _firstChange = std::chrono::steady_clock::now();
+
+            _dirty[pointer] = std::move(value);
+        }
+
+        _condition.notify_all();
+    }
+
+    void _run()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        while (true)
+        {
+            _condition.wait(lock, [this] { return !_running || _flushRequested || !_dirty.empty(); });
+
+            if (_running && !_flushRequested)
+            {
+                _condition.wait_until(lock,
+                                      _firstChange + _window,
+                                      [this] { return !_running || _flushRequested; });
+            }
+
+            std::map<std::string, nlohmann::json> dirty;
+            std::swap(dirty, _dirty);
+            _flushRequested = false;
+            bool running = _running;
+
+            lock.unlock();
+            _write(dirty);
+            lock.lock();
+
+            if (!running && _dirty.empty())
+                return;
+        }
+    }
+
+    void _write(const std::map<std::string, nlohmann::json>& dirty)
+    {
+        if (dirty.empty())
+            return;
+
+        for (const auto& entry: dirty)
+        {
+            if (entry.first.empty())
+                _document = entry.second;
+            else
+                _document[nlohmann::json::json_pointer(entry.first)] = entry.second;
+        }
+
+        // Write to a temporary file first so a crash never leaves a partial file.
+        std::string temporaryPath = _path + ".tmp";
+
+        {
+            std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+            if (!(stream << _document.dump(4)))
+            {
+                ofLogError("ParameterPersister") << "Unable to write " << temporaryPath;
+                return;
+            }
+        }
+
+        if (std::rename(temporaryPath.c_str(), _path.c_str()) != 0)
+        {
+            std::remove(_path.c_str());
+
+            if (std::rename(temporaryPath.c_str(), _path.c_str()) != 0)
+                ofLogError("ParameterPersister") << "Unable to write " << _path;
+        }
+    }
+
+    /// \brief The persisted group.
+    ofParameterGroup _group;
+
+    /// \brief The absolute output path.
+    std::string _path;
+
+    /// \brief The coalescing window.
+    std::chrono::milliseconds _window;
+
+    /// \brief The depth of the group in its own hierarchy.
+    std::size_t _depth = 0;
+
+    /// \brief The cached document. Only touched by the writer thread.
+    nlohmann::json _document;
+
+    /// \brief Serialized values waiting to be written, keyed by JSON pointer.
+    std::map<std::string, nlohmann::json> _dirty;
+
+    /// \brief The time of the first change in the current window.
+    std::chrono::steady_clock::time_point _firstChange;
+
+    /// \brief True until the persister is destroyed.
+    bool _running = true;
+
+    /// \brief True if a flush was requested.
+    bool _flushRequested = false;
+
+    /// \brief The parameter changed listener.
+    ofEventListener _listener;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::thread _thread;
+
+};
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_PARAMETER_H
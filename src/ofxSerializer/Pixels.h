@@ -0,0 +1,407 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_PIXELS_H
+#define OF_SERIALIZER_PIXELS_H
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "json.hpp"
+#include "ofxSerializer/Compression.h"
+#include "ofxSerializer/ParallelLoad.h"
+#include "ofPixels.h"
+
+
+NLOHMANN_JSON_SERIALIZE_ENUM( ofPixelFormat, {
+    { OF_PIXELS_UNKNOWN, "OF_PIXELS_UNKNOWN" },
+    { OF_PIXELS_GRAY, "OF_PIXELS_GRAY" },
+    { OF_PIXELS_GRAY_ALPHA, "OF_PIXELS_GRAY_ALPHA" },
+    { OF_PIXELS_RGB, "OF_PIXELS_RGB" },
+    { OF_PIXELS_BGR, "OF_PIXELS_BGR" },
+    { OF_PIXELS_RGBA, "OF_PIXELS_RGBA" },
+    { OF_PIXELS_BGRA, "OF_PIXELS_BGRA" },
+    { OF_PIXELS_RGB565, "OF_PIXELS_RGB565" },
+    { OF_PIXELS_NV12, "OF_PIXELS_NV12" },
+    { OF_PIXELS_NV21, "OF_PIXELS_NV21" },
+    { OF_PIXELS_YV12, "OF_PIXELS_YV12" },
+    { OF_PIXELS_I420, "OF_PIXELS_I420" },
+    { OF_PIXELS_YUY2, "OF_PIXELS_YUY2" },
+    { OF_PIXELS_UYVY, "OF_PIXELS_UYVY" },
+    { OF_PIXELS_Y, "OF_PIXELS_Y" },
+    { OF_PIXELS_U, "OF_PIXELS_U" },
+    { OF_PIXELS_V, "OF_PIXELS_V" },
+    { OF_PIXELS_UV, "OF_PIXELS_UV" },
+    { OF_PIXELS_VU, "OF_PIXELS_VU" },
+    { OF_PIXELS_NATIVE, "OF_PIXELS_NATIVE" }
+})
+
+
+/// \brief Serialize pixels with their raw data as a binary value.
+///
+/// For float and 16-bit pixels, ofx::Serializer::CompressedPixelsToJson()
+/// is usually much smaller.
+template<typename PixelType>
+void to_json(nlohmann::json& j, const ofPixels_<PixelType>& v)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(v.getData());
+
+    j["width"] = v.getWidth();
+    j["height"] = v.getHeight();
+    j["pixel_format"] = v.getPixelFormat();
+    j["pixels"] = nlohmann::json::binary(std::vector<uint8_t>(bytes, bytes + v.getTotalBytes()));
+}
+
+
+template<typename PixelType>
+void from_json(const nlohmann::json& j, ofPixels_<PixelType>& v)
+{
+    v.allocate(j.at("width").get<std::size_t>(),
+               j.at("height").get<std::size_t>(),
+               j.at("pixel_format").get<ofPixelFormat>());
+
+    const auto& bytes = j.at("pixels").get_binary();
+    std::memcpy(v.getData(), bytes.data(), std::min(bytes.size(), v.getTotalBytes()));
+}
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief Options for the lossless compression of pixels.
+struct PixelsEncoding
+{
+    /// \brief The entropy coder applied to each band.
+    CompressionSettings compression = CompressionSettings(IsCompressionSupported(Compression::ZLIB) ? Compression::ZLIB : Compression::NONE);
+
+    /// \brief Replace each sample by its difference from the previous
+    ///        sample of the same channel, XOR for floats and subtraction
+    ///        for integers.
+    bool predict = true;
+
+    /// \brief Group the bytes of the samples into planes, so that the
+    ///        slowly changing high bytes compress together.
+    bool shuffle = true;
+
+    /// \brief The number of rows in each independently compressed band,
+    ///        or 0 to compress the image as a single band.
+    std::size_t rowsPerBand = 0;
+
+    /// \brief The number of threads compressing bands, or 0 to use all
+    ///        hardware threads.
+    std::size_t threads = 1;
+};
+
+
+/// \brief The prediction and byte shuffling kernels for pixel compression.
+template<typename PixelType>
+struct PixelsCodec
+{
+    typedef typename std::conditional<sizeof(PixelType) == 1, uint8_t,
+            typename std::conditional<sizeof(PixelType) == 2, uint16_t,
+            typename std::conditional<sizeof(PixelType) == 4, uint32_t, uint64_t>::type>::type>::type Bits;
+
+    static_assert(sizeof(Bits) == sizeof(PixelType), "Unsupported pixel type.");
+
+    /// \brief Floats are predicted with XOR, integers with subtraction.
+    static const bool XOR = std::is_floating_point<PixelType>::value;
+
+    /// \returns the name of the predictor.
+    static std::string predictor()
+    {
+        return XOR ? "xor" : "delta";
+    }
+
+    /// \brief Encode rows of samples.
+    /// \param pixels The first sample of the band.
+    /// \param rows The number of rows.
+    /// \param stride The number of samples in each row.
+    /// \param channels The distance between neighbouring samples of a channel.
+    /// \param encoding The encoding options.
+    /// \param output The rows * stride * sizeof(PixelType) encoded bytes.
+    static void encode(const PixelType* pixels,
+                       std::size_t rows,
+                       std::size_t stride,
+                       std::size_t channels,
+                       const PixelsEncoding& encoding,
+                       uint8_t* output)
+    {
+        const std::size_t count = rows * stride;
+        std::vector<Bits> residuals(count);
+        std::memcpy(residuals.data(), pixels, count * sizeof(Bits));
+
+        if (encoding.predict)
+        {
+            // Walk backwards so every prediction reads an original sample.
+            for (std::size_t row = rows; row-- > 0;)
+            {
+                Bits* current = residuals.data() + row * stride;
+
+                for (std::size_t i = stride; i-- > channels;)
+                    current[i] = _residual(current[i], current[i - channels]);
+
+                if (row > 0)
+                {
+                    const Bits* above = current - stride;
+                    for (std::size_t i = 0; i < std::min(channels, stride); ++i)
+                        current[i] = _residual(current[i], above[i]);
+                }
+            }
+        }
+
+        if (encoding.shuffle && sizeof(Bits) > 1)
+        {
+            for (std::size_t b = 0; b < sizeof(Bits); ++b)
+            {
+                uint8_t* plane = output + b * count;
+                for (std::size_t i = 0; i < count; ++i)
+                    plane[i] = uint8_t(residuals[i] >> (8 * b));
+            }
+        }
+        else
+        {
+            std::memcpy(output, residuals.data(), count * sizeof(Bits));
+        }
+    }
+
+    /// \brief Decode rows of samples written by encode().
+    static void decode(const uint8_t* input,
+                       std::size_t rows,
+                       std::size_t stride,
+                       std::size_t channels,
+                       bool predict,
+                       bool shuffle,
+                       PixelType* pixels)
+    {
+        const std::size_t count = rows * stride;
+        std::vector<Bits> values(count);
+
+        if (shuffle && sizeof(Bits) > 1)
+        {
+            for (std::size_t b = 0; b < sizeof(Bits); ++b)
+            {
+                const uint8_t* plane = input + b * count;
+                for (std::size_t i = 0; i < count; ++i)
+                    values[i] |= Bits(Bits(plane[i]) << (8 * b));
+            }
+        }
+        else
+        {
+            std::memcpy(values.data(), input, count * sizeof(Bits));
+        }
+
+        if (predict)
+        {
+            for (std::size_t row = 0; row < rows; ++row)
+            {
+                Bits* current = values.data() + row * stride;
+
+                if (row > 0)
+                {
+                    const Bits* above = current - stride;
+                    for (std::size_t i = 0; i < std::min(channels, stride); ++i)
+                        current[i] = _value(current[i], above[i]);
+                }
+
+                for (std::size_t i = channels; i < stride; ++i)
+                    current[i] = _value(current[i], current[i - channels]);
+            }
+        }
+
+        std::memcpy(pixels, values.data(), count * sizeof(Bits));
+    }
+
+private:
+    static Bits _residual(Bits value, Bits prediction)
+    {
+        return XOR ? Bits(value ^ prediction) : Bits(value - prediction);
+    }
+
+    static Bits _value(Bits residual, Bits prediction)
+    {
+        return XOR ? Bits(residual ^ prediction) : Bits(residual + prediction);
+    }
+
+};
+
+
+/// \brief Serialize pixels with lossless compression.
+///
+/// Samples are predicted from their neighbours, shuffled into byte planes
+/// and compressed. This is designed for float depth and HDR images and
+/// 16-bit depth images, and decodes bit-exact. With rowsPerBand set, bands
+/// of rows are encoded independently and in parallel.
+///
+/// \param pixels The pixels to serialize.
+/// \param encoding The encoding options.
+/// \returns the serialized pixels.
+/// \throws std::runtime_error if compression fails.
+template<typename PixelType>
+nlohmann::json CompressedPixelsToJson(const ofPixels_<PixelType>& pixels,
+                                      const PixelsEncoding& encoding = PixelsEncoding())
+{
+    typedef PixelsCodec<PixelType> Codec;
+
+    const std::size_t height = pixels.getHeight();
+    const std::size_t stride = pixels.getBytesStride() / sizeof(PixelType);
+    const std::size_t channels = std::max(std::size_t(1), std::size_t(pixels.getNumChannels()));
+
+    // Planar formats do not have uniform rows and are encoded as one band.
+    const bool rowsAreUniform = stride * height * sizeof(PixelType) == pixels.getTotalBytes();
+    const std::size_t rowsPerBand = std::max(std::size_t(1), (rowsAreUniform && encoding.rowsPerBand > 0) ? encoding.rowsPerBand : height);
+    const std::size_t bandCount = rowsAreUniform ? (height + rowsPerBand - 1) / rowsPerBand : 1;
+
+    std::vector<std::vector<uint8_t>> bands(bandCount);
+    std::vector<std::exception_ptr> errors(bandCount);
+
+    // ParallelFor() terminates if the function throws, so errors are
+    // recorded and rethrown after the bands are done.
+    ParallelFor(bandCount, encoding.threads, [&](std::size_t band)
+    {
+        const std::size_t firstRow = band * rowsPerBand;
+        const std::size_t rows = rowsAreUniform ? std::min(rowsPerBand, height - firstRow) : 1;
+        const std::size_t bandStride = rowsAreUniform ? stride : pixels.size();
+
+        try
+        {
+            std::vector<uint8_t> encoded(rows * bandStride * sizeof(PixelType));
+            Codec::encode(pixels.getData() + firstRow * stride, rows, bandStride, channels, encoding, encoded.data());
+
+            if (encoding.compression.compression == Compression::NONE)
+                bands[band] = std::move(encoded);
+            else
+                bands[band] = CompressBytes(encoded.data(), encoded.size(), encoding.compression);
+        }
+        catch (...)
+        {
+            errors[band] = std::current_exception();
+        }
+    });
+
+    for (const auto& error: errors)
+        if (error)
+            std::rethrow_exception(error);
+
+    nlohmann::json j;
+    j["width"] = pixels.getWidth();
+    j["height"] = height;
+    j["pixel_format"] = pixels.getPixelFormat();
+    j["sample_size"] = sizeof(PixelType);
+    j["predictor"] = encoding.predict ? Codec::predictor() : "none";
+    j["shuffle"] = encoding.shuffle;
+    j["compressed"] = encoding.compression.compression != Compression::NONE;
+    j["rows_per_band"] = rowsAreUniform ? rowsPerBand : 0;
+
+    nlohmann::json values = nlohmann::json::array();
+    for (auto& band: bands)
+        values.push_back(nlohmann::json::binary(std::move(band)));
+    j["bands"] = std::move(values);
+
+    return j;
+}
+
+
+/// \brief Deserialize pixels written by CompressedPixelsToJson().
+/// \param j The serialized pixels.
+/// \param pixels The pixels to fill.
+/// \param threads The number of threads decoding bands, or 0 to use all
+///        hardware threads.
+/// \throws std::invalid_argument if the data is invalid.
+template<typename PixelType>
+void CompressedPixelsFromJson(const nlohmann::json& j,
+                              ofPixels_<PixelType>& pixels,
+                              std::size_t threads = 1)
+{
+    typedef PixelsCodec<PixelType> Codec;
+
+    if (j.at("sample_size").get<std::size_t>() != sizeof(PixelType))
+        throw std::invalid_argument("The pixel sample size does not match.");
+
+    const std::string predictor = j.value("predictor", "none");
+
+    if (predictor != "none" && predictor != Codec::predictor())
+        throw std::invalid_argument("Unknown pixel predictor " + predictor + ".");
+
+    pixels.allocate(j.at("width").get<std::size_t>(),
+                    j.at("height").get<std::size_t>(),
+                    j.at("pixel_format").get<ofPixelFormat>());
+
+    const std::size_t height = pixels.getHeight();
+    const std::size_t stride = pixels.getBytesStride() / sizeof(PixelType);
+    const std::size_t channels = std::max(std::size_t(1), std::size_t(pixels.getNumChannels()));
+    const std::size_t rowsPerBand = j.value("rows_per_band", std::size_t(0));
+    const bool predict = predictor != "none";
+    const bool shuffle = j.value("shuffle", false);
+    const bool compressed = j.value("compressed", false);
+    const auto& bands = j.at("bands");
+
+    const std::size_t bandCount = rowsPerBand > 0 ? (height + rowsPerBand - 1) / rowsPerBand : 1;
+
+    if (!bands.is_array() || bands.size() != bandCount)
+        throw std::invalid_argument("The number of pixel bands does not match.");
+
+    // Check the bands here, as ParallelFor() terminates if the function
+    // throws.
+    for (const auto& band: bands)
+        if (!band.is_binary())
+            throw std::invalid_argument("Pixel bands must be binary.");
+
+    std::vector<std::string> errors(bandCount);
+
+    ParallelFor(bandCount, threads, [&](std::size_t band)
+    {
+        const std::size_t firstRow = band * rowsPerBand;
+        const std::size_t rows = rowsPerBand > 0 ? std::min(rowsPerBand, height - firstRow) : 1;
+        const std::size_t bandStride = rowsPerBand > 0 ? stride : pixels.size();
+        const std::size_t size = rows * bandStride * sizeof(PixelType);
+        const auto& bytes = bands[band].get_binary();
+
+        std::vector<uint8_t> decompressed;
+        const uint8_t* encoded = bytes.data();
+
+        if (compressed)
+        {
+            try
+            {
+                decompressed.resize(size);
+
+                if (!DecompressBytes(bytes.data(), bytes.size(), decompressed.data(), size))
+                    errors[band] = "Invalid compressed pixel band.";
+            }
+            catch (const std::exception& exc)
+            {
+                errors[band] = exc.what();
+            }
+
+            encoded = decompressed.data();
+        }
+        else if (bytes.size() != size)
+        {
+            errors[band] = "Invalid pixel band size.";
+        }
+
+        if (errors[band].empty())
+            Codec::decode(encoded, rows, bandStride, channels, predict, shuffle, pixels.getData() + firstRow * stride);
+    });
+
+    for (const auto& error: errors)
+        if (!error.empty())
+            throw std::invalid_argument(error);
+}
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_PIXELS_H
@@ -0,0 +1,46 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_POLYLINE_H
+#define OF_SERIALIZER_POLYLINE_H
+
+
+#include "json.hpp"
+#include "ofxSerializer/Glm.h"
+#include "ofPolyline.h"
+
+
+template<typename VertexType>
+void to_json(nlohmann::json& j, const ofPolyline_<VertexType>& v)
+{
+    j["is_closed"] = v.isClosed();
+    nlohmann::json vertices = nlohmann::json::array();
+    for (auto& vertex: v)
+        vertices.push_back(vertex);
+    j["vertices"] = vertices;
+}
+
+
+template<typename VertexType>
+void from_json(const nlohmann::json& j, ofPolyline_<VertexType>& v)
+{
+    const auto& vertices = j["vertices"];
+    for (auto& vertex: vertices)
+        v.addVertex(vertex.get<VertexType>());
+    v.setClosed(j.value("is_closed", false));
+}
+
+
+#ifndef OF_SERIALIZER_NO_EXTERN_TEMPLATES
+
+extern template void to_json(nlohmann::json& j, const ofPolyline& v);
+extern template void from_json(const nlohmann::json& j, ofPolyline& v);
+
+#endif
+
+
+#endif // OF_SERIALIZER_POLYLINE_H
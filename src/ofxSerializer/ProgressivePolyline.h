@@ -0,0 +1,294 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_PROGRESSIVE_POLYLINE_H
+#define OF_SERIALIZER_PROGRESSIVE_POLYLINE_H
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "json.hpp"
+#include "ofxSerializer/Glm.h"
+#include "ofPolyline.h"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief Options for the progressive encoding of polylines.
+struct ProgressivePolylineEncoding
+{
+    /// \brief The ratio between the tolerances of consecutive layers.
+    float ratio = 4;
+
+    /// \brief The maximum number of layers, including the final exact layer.
+    std::size_t maxLayers = 8;
+
+    /// \brief Store layers as binary values rather than arrays.
+    ///
+    /// Binary values are compact in CBOR, MessagePack and BSON output.
+    bool binary = true;
+};
+
+
+/// \brief Compute the simplification tolerance at which each vertex is needed.
+///
+/// The Ramer-Douglas-Peucker algorithm keeps a vertex at tolerance t if its
+/// importance is greater than t. Importances never exceed the importance of
+/// the vertex that split their span, so the vertices kept at any tolerance
+/// are exactly those kept by Ramer-Douglas-Peucker at that tolerance. The
+/// first and last vertices have infinite importance.
+///
+/// \param vertices The polyline vertices.
+/// \returns the importance of each vertex.
+template<typename VertexType>
+std::vector<float> PolylineVertexImportance(const std::vector<VertexType>& vertices)
+{
+    const std::size_t count = vertices.size();
+    std::vector<float> importance(count, std::numeric_limits<float>::infinity());
+
+    if (count < 3)
+        return importance;
+
+    struct Span
+    {
+        std::size_t first;
+        std::size_t last;
+        float limit;
+    };
+
+    std::vector<Span> spans;
+    spans.push_back({ 0, count - 1, std::numeric_limits<float>::infinity() });
+
+    while (!spans.empty())
+    {
+        const Span span = spans.back();
+        spans.pop_back();
+
+        if (span.last <= span.first + 1)
+            continue;
+
+        const VertexType& a = vertices[span.first];
+        const VertexType ab = vertices[span.last] - a;
+        const float length2 = glm::dot(ab, ab);
+
+        std::size_t farthest = span.first + 1;
+        float farthestDistance2 = -1;
+
+        for (std::size_t i = span.first + 1; i < span.last; ++i)
+        {
+            const VertexType ap = vertices[i] - a;
+            const float t = length2 > 0 ? glm::clamp(glm::dot(ap, ab) / length2, 0.0f, 1.0f) : 0.0f;
+            const VertexType d = ap - ab * t;
+            const float distance2 = glm::dot(d, d);
+
+            if (distance2 > farthestDistance2)
+            {
+                farthest = i;
+                farthestDistance2 = distance2;
+            }
+        }
+
+        const float value = std::min(std::sqrt(farthestDistance2), span.limit);
+        importance[farthest] = value;
+
+        spans.push_back({ span.first, farthest, value });
+        spans.push_back({ farthest, span.last, value });
+    }
+
+    return importance;
+}
+
+
+/// \brief Serialize a polyline as progressively refined layers.
+///
+/// The first layer is a coarse Ramer-Douglas-Peucker simplification and each
+/// following layer adds the vertices needed to reach a smaller tolerance. The
+/// last layer has a tolerance of 0 and completes the polyline. Each layer
+/// stores its vertices with their indices in the original polyline.
+///
+/// \param polyline The polyline to serialize.
+/// \param encoding The encoding options.
+/// \returns the serialized polyline.
+template<typename VertexType>
+nlohmann::json ProgressivePolylineToJson(const ofPolyline_<VertexType>& polyline,
+                                         const ProgressivePolylineEncoding& encoding = ProgressivePolylineEncoding())
+{
+    const auto& vertices = polyline.getVertices();
+    const std::vector<float> importance = PolylineVertexImportance(vertices);
+
+    float maximum = 0;
+    for (float value: importance)
+        if (value != std::numeric_limits<float>::infinity())
+            maximum = std::max(maximum, value);
+
+    // Sort by decreasing importance, so each layer is a contiguous range.
+    std::vector<uint32_t> order(vertices.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+        order[i] = uint32_t(i);
+
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+    {
+        return importance[a] > importance[b];
+    });
+
+    nlohmann::json layers = nlohmann::json::array();
+
+    const std::size_t maxLayers = std::max(std::size_t(1), encoding.maxLayers);
+    const float ratio = std::max(encoding.ratio, 1.0f + std::numeric_limits<float>::epsilon());
+
+    std::size_t begin = 0;
+    float tolerance = maximum;
+
+    for (std::size_t layer = 0; layer < maxLayers && begin < order.size(); ++layer)
+    {
+        // Only the last layer takes every remaining vertex. When all interior
+        // vertices have importance 0 the first layer keeps only the endpoints,
+        // and the next layer is the last.
+        const bool last = layer + 1 == maxLayers || (layer > 0 && tolerance == 0);
+        tolerance = last ? 0 : tolerance / ratio;
+
+        std::size_t end = begin;
+        while (end < order.size() && (last || importance[order[end]] > tolerance))
+            ++end;
+
+        if (end == order.size())
+            tolerance = 0;
+
+        // Indices are sorted so the loader can merge layers in order.
+        std::vector<uint32_t> indices(order.begin() + begin, order.begin() + end);
+        std::sort(indices.begin(), indices.end());
+
+        std::vector<VertexType> values(indices.size());
+        for (std::size_t i = 0; i < indices.size(); ++i)
+            values[i] = vertices[indices[i]];
+
+        nlohmann::json j;
+        j["tolerance"] = tolerance;
+        j["count"] = indices.size();
+
+        if (encoding.binary)
+        {
+            const uint8_t* indexBytes = reinterpret_cast<const uint8_t*>(indices.data());
+            const uint8_t* vertexBytes = reinterpret_cast<const uint8_t*>(values.data());
+            j["indices"] = nlohmann::json::binary(std::vector<uint8_t>(indexBytes, indexBytes + indices.size() * sizeof(uint32_t)));
+            j["vertices"] = nlohmann::json::binary(std::vector<uint8_t>(vertexBytes, vertexBytes + values.size() * sizeof(VertexType)));
+        }
+        else
+        {
+            j["indices"] = indices;
+            j["vertices"] = values;
+        }
+
+        layers.push_back(j);
+        begin = end;
+    }
+
+    nlohmann::json j;
+    j["is_closed"] = polyline.isClosed();
+    j["count"] = vertices.size();
+    j["layers"] = layers;
+    return j;
+}
+
+
+/// \brief Deserialize a polyline written by ProgressivePolylineToJson().
+///
+/// Layers are loaded in order until the requested tolerance is reached or
+/// the next layer would exceed the byte budget. The first layer is always
+/// loaded, so the result is always a valid polyline that keeps the first
+/// and last vertices.
+///
+/// \param j The serialized polyline.
+/// \param polyline The polyline to fill.
+/// \param tolerance The largest acceptable simplification tolerance.
+///        0 loads every layer.
+/// \param byteBudget The maximum number of vertex and index bytes to load,
+///        or 0 for no limit.
+/// \returns the tolerance of the loaded polyline.
+template<typename VertexType>
+float ProgressivePolylineFromJson(const nlohmann::json& j,
+                                  ofPolyline_<VertexType>& polyline,
+                                  float tolerance = 0,
+                                  std::size_t byteBudget = 0)
+{
+    const auto& layers = j.at("layers");
+
+    std::vector<std::pair<uint32_t, VertexType>> merged;
+    std::size_t bytes = 0;
+    float loaded = std::numeric_limits<float>::infinity();
+
+    for (const auto& layer: layers)
+    {
+        const std::size_t count = layer.at("count");
+        const std::size_t size = count * (sizeof(uint32_t) + sizeof(VertexType));
+
+        if (!merged.empty() && ((tolerance > 0 && loaded <= tolerance) || (byteBudget > 0 && bytes + size > byteBudget)))
+            break;
+
+        const std::size_t previous = merged.size();
+        merged.resize(previous + count);
+
+        const auto& indices = layer.at("indices");
+        const auto& vertices = layer.at("vertices");
+
+        if (indices.is_binary() && vertices.is_binary())
+        {
+            const auto& indexBytes = indices.get_binary();
+            const auto& vertexBytes = vertices.get_binary();
+
+            if (indexBytes.size() < count * sizeof(uint32_t) || vertexBytes.size() < count * sizeof(VertexType))
+                throw std::invalid_argument("Truncated progressive polyline layer.");
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                std::memcpy(&merged[previous + i].first, indexBytes.data() + i * sizeof(uint32_t), sizeof(uint32_t));
+                std::memcpy(&merged[previous + i].second, vertexBytes.data() + i * sizeof(VertexType), sizeof(VertexType));
+            }
+        }
+        else
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                merged[previous + i].first = indices.at(i).get<uint32_t>();
+                merged[previous + i].second = vertices.at(i).get<VertexType>();
+            }
+        }
+
+        // Each layer is sorted by index, so merging keeps the polyline order.
+        std::inplace_merge(merged.begin(), merged.begin() + previous, merged.end(),
+                           [](const std::pair<uint32_t, VertexType>& a, const std::pair<uint32_t, VertexType>& b)
+        {
+            return a.first < b.first;
+        });
+
+        bytes += size;
+        loaded = layer.value("tolerance", 0.0f);
+    }
+
+    polyline.clear();
+
+    for (const auto& vertex: merged)
+        polyline.addVertex(vertex.second);
+
+    polyline.setClosed(j.value("is_closed", false));
+
+    return loaded;
+}
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_PROGRESSIVE_POLYLINE_H
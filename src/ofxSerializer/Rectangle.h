@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_RECTANGLE_H
+#define OF_SERIALIZER_RECTANGLE_H
+
+
+#include "json.hpp"
+#include "ofRectangle.h"
+
+
+NLOHMANN_JSON_SERIALIZE_ENUM( ofAspectRatioMode, {
+    { OF_ASPECT_RATIO_IGNORE, "OF_ASPECT_RATIO_IGNORE" },
+    { OF_ASPECT_RATIO_KEEP, "OF_ASPECT_RATIO_KEEP"},
+    { OF_ASPECT_RATIO_KEEP_BY_EXPANDING, "OF_ASPECT_RATIO_KEEP_BY_EXPANDING"}
+})
+
+
+NLOHMANN_JSON_SERIALIZE_ENUM( ofAlignVert, {
+    { OF_ALIGN_VERT_IGNORE, "OF_ALIGN_VERT_IGNORE" },
+    { OF_ALIGN_VERT_TOP, "OF_ALIGN_VERT_TOP"},
+    { OF_ALIGN_VERT_BOTTOM, "OF_ALIGN_VERT_BOTTOM"},
+    { OF_ALIGN_VERT_CENTER, "OF_ALIGN_VERT_CENTER"}
+})
+
+
+NLOHMANN_JSON_SERIALIZE_ENUM( ofAlignHorz, {
+    { OF_ALIGN_HORZ_IGNORE, "OF_ALIGN_HORZ_IGNORE" },
+    { OF_ALIGN_HORZ_LEFT, "OF_ALIGN_HORZ_LEFT"},
+    { OF_ALIGN_HORZ_RIGHT, "OF_ALIGN_HORZ_RIGHT"},
+    { OF_ALIGN_HORZ_CENTER, "OF_ALIGN_HORZ_CENTER"}
+})
+
+
+NLOHMANN_JSON_SERIALIZE_ENUM( ofScaleMode, {
+    { OF_SCALEMODE_FIT, "OF_SCALEMODE_FIT" },
+    { OF_SCALEMODE_FILL, "OF_SCALEMODE_FILL"},
+    { OF_SCALEMODE_CENTER, "OF_SCALEMODE_CENTER"},
+    { OF_SCALEMODE_STRETCH_TO_FILL, "OF_SCALEMODE_STRETCH_TO_FILL"}
+})
+
+
+inline void to_json(nlohmann::json& j, const ofRectangle& v)
+{
+    j = { { "x", v.x }, { "y", v.y }, { "width", v.width }, { "height", v.height } };
+}
+
+
+inline void from_json(const nlohmann::json& j, ofRectangle& v)
+{
+    v.x = j.value("x", float(0.0f));
+    v.y = j.value("y", float(0.0f));
+    v.width = j.value("width", float(0.0f));
+    v.height = j.value("height", float(0.0f));
+}
+
+
+#endif // OF_SERIALIZER_RECTANGLE_H
@@ -0,0 +1,248 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_SERIALIZATION_CACHE_H
+#define OF_SERIALIZER_SERIALIZATION_CACHE_H
+
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <vector>
+#include "json.hpp"
+#include "ofxSerializer/ContentHash.h"
+#include "ofxSerializer/Document.h"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief Memoizes the encoding of objects that are serialized repeatedly.
+///
+/// Each object is identified by its address and type. When an object is
+/// encoded again and its content hash is unchanged, the cached bytes are
+/// returned without calling to_json(). Entries are evicted in least recently
+/// used order once the cached bytes exceed the capacity.
+///
+/// Types without a HashContent() overload are converted to JSON to compute
+/// their hash, which costs about as much as encoding them. On a miss that
+/// JSON is encoded rather than converting the object again, but only types
+/// with an overload benefit from the cache.
+///
+/// The cache is thread-safe. Objects are encoded outside of the lock.
+class SerializationCache
+{
+public:
+    /// \brief Shared, immutable encoded bytes.
+    typedef std::shared_ptr<const std::vector<uint8_t>> Bytes;
+
+    /// \brief Create a serialization cache.
+    /// \param capacity The maximum number of cached bytes.
+    SerializationCache(std::size_t capacity = 64 << 20): _capacity(capacity)
+    {
+    }
+
+    /// \brief Encode an object, reusing the cached bytes if it is unchanged.
+    /// \param value The object to encode.
+    /// \param format The document format.
+    /// \returns the encoded object.
+    template<typename T>
+    Bytes encode(const T& value, DocumentFormat format = DocumentFormat::CBOR)
+    {
+        const Key key(&value, typeid(T));
+
+        nlohmann::json json;
+        const uint64_t hash = _hash(value, json, HasHashContent<T>());
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            auto iter = _entries.find(key);
+
+            if (iter != _entries.end()
+            && iter->second.hash == hash
+            && iter->second.format == format)
+            {
+                _order.splice(_order.begin(), _order, iter->second.order);
+                ++_hits;
+                return iter->second.bytes;
+            }
+
+            ++_misses;
+        }
+
+        if (HasHashContent<T>::value)
+            json = value;
+
+        Bytes bytes = std::make_shared<const std::vector<uint8_t>>(EncodeDocument(json, format));
+        _insert(key, hash, format, bytes);
+        return bytes;
+    }
+
+    /// \brief Check whether an object changed since it was last encoded.
+    /// \param value The object to check.
+    /// \returns true if the object was not encoded or its content changed.
+    template<typename T>
+    bool changed(const T& value) const
+    {
+        const Key key(&value, typeid(T));
+        const uint64_t hash = ContentHash(value);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto iter = _entries.find(key);
+        return iter == _entries.end() || iter->second.hash != hash;
+    }
+
+    /// \brief Remove an object from the cache.
+    ///
+    /// Call this before an encoded object is destroyed so that its cached
+    /// bytes are released immediately instead of by eviction.
+    ///
+    /// \param value The object to remove.
+    template<typename T>
+    void erase(const T& value)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto iter = _entries.find(Key(&value, typeid(T)));
+
+        if (iter != _entries.end())
+            _erase(iter);
+    }
+
+    /// \brief Remove all cached entries.
+    void clear()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _entries.clear();
+        _order.clear();
+        _size = 0;
+    }
+
+    /// \brief Set the maximum number of cached bytes, evicting as needed.
+    /// \param capacity The maximum number of cached bytes.
+    void setCapacity(std::size_t capacity)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _capacity = capacity;
+        _evict();
+    }
+
+    /// \returns the maximum number of cached bytes.
+    std::size_t capacity() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _capacity;
+    }
+
+    /// \returns the number of cached bytes.
+    std::size_t size() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _size;
+    }
+
+    /// \returns the number of encodings served from the cache.
+    uint64_t hits() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _hits;
+    }
+
+    /// \returns the number of encodings that called to_json().
+    uint64_t misses() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _misses;
+    }
+
+private:
+    typedef std::pair<const void*, std::type_index> Key;
+
+    struct Entry
+    {
+        uint64_t hash = 0;
+        DocumentFormat format = DocumentFormat::CBOR;
+        Bytes bytes;
+        std::list<Key>::iterator order;
+    };
+
+    typedef std::map<Key, Entry> Entries;
+
+    template<typename T>
+    static uint64_t _hash(const T& value, nlohmann::json&, std::true_type)
+    {
+        return ContentHash(value);
+    }
+
+    /// \brief Hash a value through its JSON representation, keeping the JSON.
+    template<typename T>
+    static uint64_t _hash(const T& value, nlohmann::json& json, std::false_type)
+    {
+        json = value;
+        return ContentHash(json);
+    }
+
+    void _insert(const Key& key, uint64_t hash, DocumentFormat format, const Bytes& bytes)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        auto iter = _entries.find(key);
+
+        if (iter != _entries.end())
+            _erase(iter);
+
+        // Encodings larger than the whole cache are returned uncached.
+        if (bytes->size() > _capacity)
+            return;
+
+        _order.push_front(key);
+
+        Entry& entry = _entries[key];
+        entry.hash = hash;
+        entry.format = format;
+        entry.bytes = bytes;
+        entry.order = _order.begin();
+
+        _size += bytes->size();
+        _evict();
+    }
+
+    void _erase(Entries::iterator iter)
+    {
+        _size -= iter->second.bytes->size();
+        _order.erase(iter->second.order);
+        _entries.erase(iter);
+    }
+
+    void _evict()
+    {
+        while (_size > _capacity && !_order.empty())
+            _erase(_entries.find(_order.back()));
+    }
+
+    mutable std::mutex _mutex;
+    Entries _entries;
+
+    /// \brief Keys from the most to the least recently used.
+    std::list<Key> _order;
+
+    std::size_t _capacity = 0;
+    std::size_t _size = 0;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+
+};
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_SERIALIZATION_CACHE_H
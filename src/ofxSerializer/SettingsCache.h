@@ -0,0 +1,219 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_SETTINGS_CACHE_H
+#define OF_SERIALIZER_SETTINGS_CACHE_H
+
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "ofxSerializer/ContentHash.h"
+#include "ofxSerializer/FileStamp.h"
+#include "ofFileUtils.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief The header of a cached JSON document.
+///
+/// The header is followed by the CBOR encoded document.
+struct CachedJsonHeader
+{
+    enum
+    {
+        VERSION = 1
+    };
+
+    char magic[4] = { 'o', 'f', 'S', 'C' };
+    uint32_t version = VERSION;
+
+    /// \brief The size of the source document.
+    uint64_t size = 0;
+
+    /// \brief The modification time of the source document, or -1 if the
+    ///        source must be hashed to validate the cache.
+    int64_t modified = -1;
+
+    /// \brief The content hash of the source document.
+    uint64_t hash = 0;
+
+    bool isValid() const
+    {
+        return std::memcmp(magic, "ofSC", 4) == 0 && version == VERSION;
+    }
+};
+
+
+/// \returns the path of the cache written next to a JSON document.
+inline std::string CachedJsonPathFor(const std::string& path)
+{
+    return path + ".cbor";
+}
+
+
+/// \brief Write a JSON document's binary cache.
+/// \param path The absolute path of the cache.
+/// \param header The cache header.
+/// \param j The parsed document.
+/// \returns true if successful.
+inline bool SaveCachedJson(const std::string& path,
+                           const CachedJsonHeader& header,
+                           const nlohmann::json& j)
+{
+    std::vector<uint8_t> bytes = nlohmann::json::to_cbor(j);
+
+    // Write to a temporary file first so a crash never leaves a partial file.
+    std::string temporaryPath = path + ".tmp";
+
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+        if (!stream.write(reinterpret_cast<const char*>(&header), sizeof(header))
+        ||  !stream.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size())))
+        {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(path.c_str());
+
+        if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+
+/// \brief Load a JSON document through an automatically maintained binary cache.
+///
+/// The first load parses the JSON text and writes a CBOR copy of the parsed
+/// document next to it. Later loads read the CBOR copy instead while the
+/// source has the same size and modification time. If only the modification
+/// time changed, e.g. after a copy, the source is hashed and the copy is
+/// reused if the content is unchanged. Otherwise the source is parsed again
+/// and the copy is regenerated.
+///
+/// This can be used in place of ofLoadJson() for large settings files.
+///
+/// \param filename The JSON document.
+/// \returns the document, or null if it could not be loaded.
+inline nlohmann::json LoadCachedJson(const std::string& filename)
+{
+    const std::string path = ofToDataPath(filename, true);
+    const std::string cachePath = CachedJsonPathFor(path);
+    const FileStamp source = FileStamp::fromFile(path);
+
+    if (!source.exists)
+    {
+        ofLogError("LoadCachedJson") << "Unable to open " << filename;
+        return nullptr;
+    }
+
+    CachedJsonHeader header;
+    std::vector<uint8_t> payload;
+
+    auto readCache = [&]()
+    {
+        std::ifstream stream(cachePath, std::ios::binary | std::ios::ate);
+
+        if (!stream)
+            return false;
+
+        std::streamoff size = stream.tellg();
+
+        if (size < std::streamoff(sizeof(header)))
+            return false;
+
+        stream.seekg(0);
+        payload.resize(std::size_t(size) - sizeof(header));
+
+        return stream.read(reinterpret_cast<char*>(&header), sizeof(header))
+            && header.isValid()
+            && stream.read(reinterpret_cast<char*>(payload.data()), std::streamsize(payload.size()));
+    };
+
+    const bool haveCache = readCache();
+
+    if (haveCache && header.size == source.size && header.modified == source.modified)
+    {
+        try
+        {
+            return nlohmann::json::from_cbor(payload);
+        }
+        catch (const std::exception& exc)
+        {
+            ofLogWarning("LoadCachedJson") << "Regenerating invalid cache " << cachePath << ": " << exc.what();
+        }
+    }
+
+    std::string text;
+
+    {
+        std::ifstream stream(path, std::ios::binary);
+        text.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    CachedJsonHeader current;
+    current.size = text.size();
+    current.hash = ContentHasher::hash(text.data(), text.size());
+
+    // A file modified within the last two seconds could be modified again
+    // without changing its stamp, so the cache must be validated by hash.
+    if (source.modified < int64_t(std::time(nullptr)) - 2)
+        current.modified = source.modified;
+
+    nlohmann::json j;
+
+    if (haveCache && header.size == current.size && header.hash == current.hash)
+    {
+        try
+        {
+            j = nlohmann::json::from_cbor(payload);
+        }
+        catch (const std::exception&)
+        {
+        }
+    }
+
+    if (j.is_null())
+    {
+        try
+        {
+            j = nlohmann::json::parse(text);
+        }
+        catch (const std::exception& exc)
+        {
+            ofLogError("LoadCachedJson") << "Unable to parse " << filename << ": " << exc.what();
+            return nullptr;
+        }
+    }
+
+    if (!SaveCachedJson(cachePath, current, j))
+        ofLogWarning("LoadCachedJson") << "Unable to write " << cachePath;
+
+    return j;
+}
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_SETTINGS_CACHE_H
@@ -0,0 +1,308 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_SETTINGS_REGISTRY_H
+#define OF_SERIALIZER_SETTINGS_REGISTRY_H
+
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <typeindex>
+#include "json.hpp"
+#include "ofJson.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief An immutable, decoded view of a settings document.
+///
+/// A Snapshot is never modified after it has been published by a
+/// SettingsRegistry, so it can be read from any thread without locking.
+class SettingsSnapshot
+{
+public:
+    /// \brief Create a snapshot from a settings document.
+    /// \param json The settings document.
+    SettingsSnapshot(nlohmann::json json): _json(std::move(json))
+    {
+    }
+
+    /// \returns the settings document.
+    const nlohmann::json& json() const
+    {
+        return _json;
+    }
+
+    /// \brief Get a decoded value that was registered with the registry.
+    ///
+    /// The lookup does not allocate and does not lock, so it is safe to call
+    /// from real-time threads (e.g. audio callbacks).
+    ///
+    /// \param pointer The JSON pointer the value was registered with.
+    /// \returns a pointer to the decoded value or nullptr if not available.
+    template<typename T>
+    const T* get(const std::string& pointer) const
+    {
+        auto iter = _cache.find(std::make_pair(std::type_index(typeid(T)), std::cref(pointer)));
+
+        if (iter != _cache.end())
+            return static_cast<const T*>(iter->second.get());
+
+        return nullptr;
+    }
+
+private:
+    struct KeyCompare
+    {
+        using is_transparent = void;
+
+        template<typename A, typename B>
+        bool operator()(const A& a, const B& b) const
+        {
+            if (a.first != b.first)
+                return a.first < b.first;
+            return static_cast<const std::string&>(a.second) < static_cast<const std::string&>(b.second);
+        }
+    };
+
+    /// \brief The settings document.
+    nlohmann::json _json;
+
+    /// \brief Values decoded at publish time, keyed by type and JSON pointer.
+    std::map<std::pair<std::type_index, std::string>, std::shared_ptr<const void>, KeyCompare> _cache;
+
+    friend class SettingsRegistry;
+
+};
+
+
+/// \brief A registry of settings snapshots that can be read without locks.
+///
+/// Writers publish a new SettingsSnapshot by swapping an atomic pointer. The
+/// previous snapshot is released once all readers that could have seen it
+/// have finished. Readers on any thread acquire a View that pins the current
+/// snapshot without taking a mutex or allocating.
+///
+/// Typed values are decoded once per snapshot, on the publishing thread, for
+/// each accessor that was added with addAccessor().
+class SettingsRegistry
+{
+public:
+    /// \brief A pinned, read-only reference to the current snapshot.
+    class View
+    {
+    public:
+        View(View&& other) noexcept:
+            _registry(other._registry),
+            _epoch(other._epoch),
+            _snapshot(other._snapshot)
+        {
+            other._registry = nullptr;
+            other._snapshot = nullptr;
+        }
+
+        View(const View&) = delete;
+        View& operator = (const View&) = delete;
+        View& operator = (View&&) = delete;
+
+        ~View()
+        {
+            if (_registry)
+                _registry->_readers[_epoch].fetch_sub(1, std::memory_order_release);
+        }
+
+        const SettingsSnapshot* operator -> () const
+        {
+            return _snapshot;
+        }
+
+        const SettingsSnapshot& operator * () const
+        {
+            return *_snapshot;
+        }
+
+    private:
+        View(const SettingsRegistry* registry):
+            _registry(registry)
+        {
+            // Register as a reader of the current epoch. If a writer flipped
+            // the epoch in the meantime, retry so that we are always counted
+            // against the epoch a writer will wait on.
+            while (true)
+            {
+                std::size_t epoch = _registry->_epoch.load();
+                _epoch = epoch & 1;
+                _registry->_readers[_epoch].fetch_add(1);
+
+                if (_registry->_epoch.load() == epoch)
+                    break;
+
+                _registry->_readers[_epoch].fetch_sub(1);
+            }
+
+            _snapshot = _registry->_current.load();
+        }
+
+        const SettingsRegistry* _registry = nullptr;
+        std::size_t _epoch = 0;
+        const SettingsSnapshot* _snapshot = nullptr;
+
+        friend class SettingsRegistry;
+
+    };
+
+    SettingsRegistry(): SettingsRegistry(nlohmann::json::object())
+    {
+    }
+
+    /// \brief Create a registry with an initial settings document.
+    /// \param settings The initial settings document.
+    SettingsRegistry(nlohmann::json settings)
+    {
+        _current.store(new SettingsSnapshot(std::move(settings)));
+    }
+
+    SettingsRegistry(const SettingsRegistry&) = delete;
+    SettingsRegistry& operator = (const SettingsRegistry&) = delete;
+
+    /// \brief Destroy the registry.
+    ///
+    /// No View may outlive the registry.
+    ~SettingsRegistry()
+    {
+        delete _current.load();
+    }
+
+    /// \brief Pin and return the current snapshot.
+    ///
+    /// This is lock-free and does not allocate.
+    ///
+    /// \returns a View of the current snapshot.
+    View read() const
+    {
+        return View(this);
+    }
+
+    /// \brief Decode a value of type T at \p pointer for every published snapshot.
+    ///
+    /// The value is decoded with the type's from_json() overload on the
+    /// publishing thread. The current snapshot is republished so the value is
+    /// immediately available.
+    ///
+    /// \param pointer A JSON pointer (e.g. "/audio/gain") to the value.
+    template<typename T>
+    void addAccessor(const std::string& pointer)
+    {
+        std::unique_lock<std::mutex> lock(_writeMutex);
+
+        _decoders[std::make_pair(std::type_index(typeid(T)), pointer)] =
+            [pointer](const nlohmann::json& json) -> std::shared_ptr<const void>
+            {
+                const nlohmann::json* value = nullptr;
+
+                try
+                {
+                    value = &json.at(nlohmann::json::json_pointer(pointer));
+                }
+                catch (const nlohmann::json::out_of_range&)
+                {
+                    return nullptr;
+                }
+
+                return std::make_shared<const T>(value->get<T>());
+            };
+
+        _publish(_current.load()->json(), lock);
+    }
+
+    /// \brief Publish a new settings document.
+    /// \param settings The settings document to publish.
+    void publish(nlohmann::json settings)
+    {
+        std::unique_lock<std::mutex> lock(_writeMutex);
+        _publish(std::move(settings), lock);
+    }
+
+    /// \brief Load and publish a settings document from a file.
+    /// \param filename The path of the settings file.
+    /// \returns true if the file was loaded and published.
+    bool load(const std::string& filename)
+    {
+        nlohmann::json settings = ofLoadJson(filename);
+
+        if (settings.is_null())
+        {
+            ofLogError("SettingsRegistry::load") << "Unable to load " << filename;
+            return false;
+        }
+
+        publish(std::move(settings));
+        return true;
+    }
+
+private:
+    typedef std::function<std::shared_ptr<const void>(const nlohmann::json&)> Decoder;
+
+    void _publish(nlohmann::json settings, std::unique_lock<std::mutex>&)
+    {
+        auto snapshot = new SettingsSnapshot(std::move(settings));
+
+        for (const auto& decoder: _decoders)
+        {
+            try
+            {
+                auto value = decoder.second(snapshot->_json);
+                if (value)
+                    snapshot->_cache[decoder.first] = value;
+            }
+            catch (const std::exception& exc)
+            {
+                ofLogError("SettingsRegistry") << "Unable to decode " << decoder.first.second << ": " << exc.what();
+            }
+        }
+
+        const SettingsSnapshot* previous = _current.exchange(snapshot);
+
+        // Readers that entered before the flip may hold the previous snapshot.
+        // Wait for the readers of the previous epoch to drain before freeing it.
+        std::size_t epoch = _epoch.fetch_add(1) & 1;
+
+        while (_readers[epoch].load(std::memory_order_acquire) != 0)
+            std::this_thread::yield();
+
+        delete previous;
+    }
+
+    /// \brief The current snapshot.
+    std::atomic<const SettingsSnapshot*> _current { nullptr };
+
+    /// \brief The current reader epoch.
+    std::atomic<std::size_t> _epoch { 0 };
+
+    /// \brief The number of active readers for each epoch parity.
+    mutable std::atomic<std::size_t> _readers[2] = { { 0 }, { 0 } };
+
+    /// \brief Serializes writers.
+    std::mutex _writeMutex;
+
+    /// \brief Decoders run for each published snapshot.
+    std::map<std::pair<std::type_index, std::string>, Decoder> _decoders;
+
+};
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_SETTINGS_REGISTRY_H
@@ -0,0 +1,673 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_SHARED_MEMORY_H
+#define OF_SERIALIZER_SHARED_MEMORY_H
+
+
+#include "ofConstants.h"
+
+
+#if !defined(TARGET_WIN32)
+
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "json.hpp"
+#include "ofMesh.h"
+#include "ofPolyline.h"
+
+#if defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief The layout shared by SharedMemoryWriter and SharedMemoryReader.
+///
+/// The shared memory object holds a RingHeader followed by the ring data.
+/// Records are written back to back at monotonically increasing positions
+/// and never wrap around the end of the ring. Readers detect records that
+/// were overwritten while they were reading by comparing their position with
+/// the writer's reserve position.
+class SharedMemoryRing
+{
+public:
+    /// \brief Well-known record types. User types should start at USER.
+    enum RecordType: uint32_t
+    {
+        /// \brief Unused space at the end of the ring.
+        PADDING = 0,
+        /// \brief A CBOR encoded document.
+        DOCUMENT = 1,
+        /// \brief An ofMesh laid out as MeshRecordHeader and attribute arrays.
+        MESH = 2,
+        /// \brief An ofPolyline laid out as PolylineRecordHeader and vertices.
+        POLYLINE = 3,
+        /// \brief Raw bytes of a trivially copyable value.
+        VALUE = 4,
+        /// \brief The first user defined record type.
+        USER = 256
+    };
+
+    /// \brief The header at the start of the shared memory object.
+    struct RingHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t capacity;
+
+        /// \brief The position after the last published record.
+        alignas(64) std::atomic<uint64_t> writePosition;
+
+        /// \brief The position after the record currently being written.
+        std::atomic<uint64_t> reservePosition;
+
+        /// \brief Incremented for each published record. Readers wait on it.
+        alignas(64) std::atomic<uint32_t> sequence;
+
+        /// \brief The number of readers waiting for a record.
+        std::atomic<uint32_t> waiters;
+    };
+
+    /// \brief The header before each record.
+    struct RecordHeader
+    {
+        /// \brief The payload size in bytes.
+        uint32_t size;
+
+        /// \brief The record type.
+        uint32_t type;
+
+        /// \brief The position of the record, used to detect overwrites.
+        uint64_t position;
+    };
+
+    /// \brief The payload header of a MESH record.
+    struct MeshRecordHeader
+    {
+        uint32_t mode;
+        uint32_t vertexCount;
+        uint32_t normalCount;
+        uint32_t colorCount;
+        uint32_t texCoordCount;
+        uint32_t indexCount;
+        uint32_t reserved[2];
+    };
+
+    /// \brief The payload header of a POLYLINE record.
+    struct PolylineRecordHeader
+    {
+        uint32_t closed;
+        uint32_t vertexCount;
+        uint32_t reserved[2];
+    };
+
+    enum
+    {
+        MAGIC = 0x6F665352, // "ofSR"
+        VERSION = 1,
+        ALIGNMENT = 16,
+        HEADER_SIZE = (sizeof(RingHeader) + 63) & ~std::size_t(63)
+    };
+
+    /// \returns \p size rounded up to the record alignment.
+    static uint64_t align(uint64_t size)
+    {
+        return (size + ALIGNMENT - 1) & ~uint64_t(ALIGNMENT - 1);
+    }
+
+    /// \returns the total ring size of a record with a payload of \p size bytes.
+    static uint64_t recordSize(uint64_t size)
+    {
+        return align(sizeof(RecordHeader) + size);
+    }
+
+protected:
+    SharedMemoryRing() = default;
+
+    ~SharedMemoryRing()
+    {
+        if (_memory)
+            ::munmap(_memory, _mappedSize);
+    }
+
+    SharedMemoryRing(const SharedMemoryRing&) = delete;
+    SharedMemoryRing& operator = (const SharedMemoryRing&) = delete;
+
+    void _map(int fd, std::size_t size)
+    {
+        void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (memory == MAP_FAILED)
+            throw std::runtime_error("Unable to map shared memory " + _name);
+
+        _memory = memory;
+        _mappedSize = size;
+        _header = static_cast<RingHeader*>(memory);
+        _data = static_cast<uint8_t*>(memory) + HEADER_SIZE;
+    }
+
+    static void _wake(std::atomic<uint32_t>& word)
+    {
+#if defined(__linux__)
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+        (void)word;
+#endif
+    }
+
+    static void _wait(std::atomic<uint32_t>& word, uint32_t value, std::chrono::microseconds timeout)
+    {
+#if defined(__linux__)
+        struct timespec duration;
+        duration.tv_sec = time_t(timeout.count() / 1000000);
+        duration.tv_nsec = long(timeout.count() % 1000000) * 1000;
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, value, &duration, nullptr, 0);
+#else
+        // Without futexes, fall back to a short sleep.
+        if (word.load() == value)
+            std::this_thread::sleep_for(std::min(timeout, std::chrono::microseconds(500)));
+#endif
+    }
+
+    std::string _name;
+    void* _memory = nullptr;
+    std::size_t _mappedSize = 0;
+    RingHeader* _header = nullptr;
+    uint8_t* _data = nullptr;
+
+};
+
+
+/// \brief Publishes records to a shared memory ring.
+///
+/// There must be only one writer per ring. The writer never waits for
+/// readers; slow readers detect that they were overrun and skip ahead.
+class SharedMemoryWriter: public SharedMemoryRing
+{
+public:
+    /// \brief Create a shared memory ring.
+    /// \param name The POSIX shared memory name, e.g. "/tracking".
+    /// \param capacity The ring size in bytes.
+    /// \throws std::runtime_error if the ring cannot be created.
+    SharedMemoryWriter(const std::string& name, std::size_t capacity = 64 << 20)
+    {
+        _name = name;
+
+        capacity = std::size_t(align(capacity));
+        std::size_t size = HEADER_SIZE + capacity;
+
+        ::shm_unlink(name.c_str());
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+        if (fd < 0)
+            throw std::runtime_error("Unable to create shared memory " + name);
+
+        if (::ftruncate(fd, off_t(size)) != 0)
+        {
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw std::runtime_error("Unable to size shared memory " + name);
+        }
+
+        _map(fd, size);
+
+        new (_header) RingHeader();
+        _header->capacity = capacity;
+        _header->writePosition.store(0);
+        _header->reservePosition.store(0);
+        _header->sequence.store(0);
+        _header->waiters.store(0);
+        _header->version = VERSION;
+        std::atomic_thread_fence(std::memory_order_release);
+        _header->magic = MAGIC;
+    }
+
+    /// \brief Unlink the shared memory object.
+    ///
+    /// Readers that already opened the ring keep their mapping.
+    ~SharedMemoryWriter()
+    {
+        ::shm_unlink(_name.c_str());
+    }
+
+    /// \brief Write a record, encoding its payload directly into the ring.
+    /// \param type The record type.
+    /// \param size The payload size in bytes.
+    /// \param fill Called with a pointer to \p size bytes of payload to fill.
+    /// \returns false if the record is larger than the ring.
+    template<typename Fill>
+    bool write(uint32_t type, std::size_t size, Fill&& fill)
+    {
+        const uint64_t capacity = _header->capacity;
+        const uint64_t total = recordSize(size);
+
+        if (total > capacity || size > UINT32_MAX)
+            return false;
+
+        uint64_t position = _header->writePosition.load(std::memory_order_relaxed);
+        uint64_t offset = position % capacity;
+
+        // Records never wrap. Pad to the end of the ring instead.
+        if (offset + total > capacity)
+        {
+            _reserve(position + (capacity - offset));
+            _writeHeader(offset, PADDING, std::size_t(capacity - offset - sizeof(RecordHeader)), position);
+            position += capacity - offset;
+            offset = 0;
+        }
+
+        _reserve(position + total);
+        fill(_data + offset + sizeof(RecordHeader));
+        _writeHeader(offset, type, size, position);
+        _publish(position + total);
+
+        return true;
+    }
+
+    /// \brief Write raw bytes as a record.
+    /// \param type The record type.
+    /// \param data The payload.
+    /// \param size The payload size in bytes.
+    /// \returns false if the record is larger than the ring.
+    bool write(uint32_t type, const void* data, std::size_t size)
+    {
+        return write(type, size, [&](uint8_t* payload) { std::memcpy(payload, data, size); });
+    }
+
+    /// \brief Write a document as a CBOR record.
+    /// \param j The document.
+    /// \returns false if the record is larger than the ring.
+    bool writeDocument(const nlohmann::json& j)
+    {
+        std::vector<uint8_t> bytes = nlohmann::json::to_cbor(j);
+        return write(DOCUMENT, bytes.data(), bytes.size());
+    }
+
+    /// \brief Write a trivially copyable value, such as a glm::mat4.
+    /// \param value The value.
+    /// \returns false if the record is larger than the ring.
+    template<typename T>
+    bool writeValue(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "The value must be trivially copyable.");
+        return write(VALUE, &value, sizeof(T));
+    }
+
+    /// \brief Write a mesh with its attribute arrays laid out contiguously.
+    /// \param mesh The mesh.
+    /// \returns false if the record is larger than the ring.
+    bool writeMesh(const ofMesh& mesh)
+    {
+        MeshRecordHeader header = {};
+        header.mode = uint32_t(mesh.getMode());
+        header.vertexCount = uint32_t(mesh.getNumVertices());
+        header.normalCount = uint32_t(mesh.getNumNormals());
+        header.colorCount = uint32_t(mesh.getNumColors());
+        header.texCoordCount = uint32_t(mesh.getNumTexCoords());
+        header.indexCount = uint32_t(mesh.getNumIndices());
+
+        const std::size_t size = sizeof(header)
+                               + header.vertexCount * sizeof(glm::vec3)
+                               + header.normalCount * sizeof(glm::vec3)
+                               + header.colorCount * sizeof(ofFloatColor)
+                               + header.texCoordCount * sizeof(glm::vec2)
+                               + header.indexCount * sizeof(ofIndexType);
+
+        return write(MESH, size, [&](uint8_t* payload)
+        {
+            payload = _copy(payload, &header, sizeof(header));
+            payload = _copy(payload, mesh.getVerticesPointer(), header.vertexCount * sizeof(glm::vec3));
+            payload = _copy(payload, mesh.getNormalsPointer(), header.normalCount * sizeof(glm::vec3));
+            payload = _copy(payload, mesh.getColorsPointer(), header.colorCount * sizeof(ofFloatColor));
+            payload = _copy(payload, mesh.getTexCoordsPointer(), header.texCoordCount * sizeof(glm::vec2));
+            _copy(payload, mesh.getIndexPointer(), header.indexCount * sizeof(ofIndexType));
+        });
+    }
+
+    /// \brief Write a polyline with its vertices laid out contiguously.
+    /// \param polyline The polyline.
+    /// \returns false if the record is larger than the ring.
+    bool writePolyline(const ofPolyline& polyline)
+    {
+        PolylineRecordHeader header = {};
+        header.closed = polyline.isClosed() ? 1 : 0;
+        header.vertexCount = uint32_t(polyline.size());
+
+        const std::size_t size = sizeof(header) + header.vertexCount * sizeof(glm::vec3);
+
+        return write(POLYLINE, size, [&](uint8_t* payload)
+        {
+            payload = _copy(payload, &header, sizeof(header));
+            _copy(payload, polyline.getVertices().data(), header.vertexCount * sizeof(glm::vec3));
+        });
+    }
+
+private:
+    static uint8_t* _copy(uint8_t* destination, const void* source, std::size_t size)
+    {
+        if (size > 0)
+            std::memcpy(destination, source, size);
+        return destination + size;
+    }
+
+    void _reserve(uint64_t position)
+    {
+        // Readers must see the reservation before any overwritten bytes.
+        _header->reservePosition.store(position, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void _writeHeader(uint64_t offset, uint32_t type, std::size_t size, uint64_t position)
+    {
+        RecordHeader header;
+        header.size = uint32_t(size);
+        header.type = type;
+        header.position = position;
+        std::memcpy(_data + offset, &header, sizeof(header));
+    }
+
+    void _publish(uint64_t position)
+    {
+        _header->writePosition.store(position, std::memory_order_release);
+        _header->sequence.fetch_add(1, std::memory_order_release);
+
+        if (_header->waiters.load() > 0)
+            _wake(_header->sequence);
+    }
+
+};
+
+
+/// \brief A record read in place from a shared memory ring.
+struct SharedMemoryRecord
+{
+    /// \brief The record type.
+    uint32_t type = 0;
+
+    /// \brief The payload, pointing into the ring.
+    const uint8_t* data = nullptr;
+
+    /// \brief The payload size in bytes.
+    std::size_t size = 0;
+};
+
+
+/// \brief A mesh whose attribute arrays point into a shared memory ring.
+struct SharedMemoryMeshView
+{
+    ofPrimitiveMode mode = OF_PRIMITIVE_TRIANGLES;
+    const glm::vec3* vertices = nullptr;
+    std::size_t vertexCount = 0;
+    const glm::vec3* normals = nullptr;
+    std::size_t normalCount = 0;
+    const ofFloatColor* colors = nullptr;
+    std::size_t colorCount = 0;
+    const glm::vec2* texCoords = nullptr;
+    std::size_t texCoordCount = 0;
+    const ofIndexType* indices = nullptr;
+    std::size_t indexCount = 0;
+
+    /// \brief Copy the attributes into a mesh.
+    /// \param mesh The mesh to fill.
+    void copyTo(ofMesh& mesh) const
+    {
+        mesh.clear();
+        mesh.setMode(mode);
+        mesh.addVertices(vertices, vertexCount);
+        mesh.addNormals(normals, normalCount);
+        mesh.addColors(colors, colorCount);
+        mesh.addTexCoords(texCoords, texCoordCount);
+        mesh.addIndices(indices, indexCount);
+    }
+
+    /// \brief Map the attributes of a MESH record.
+    /// \param record The record.
+    /// \returns the view, or an empty view if the record is malformed.
+    static SharedMemoryMeshView fromRecord(const SharedMemoryRecord& record)
+    {
+        SharedMemoryMeshView view;
+        SharedMemoryRing::MeshRecordHeader header;
+
+        if (record.type != SharedMemoryRing::MESH || record.size < sizeof(header))
+            return view;
+
+        std::memcpy(&header, record.data, sizeof(header));
+
+        const std::size_t size = sizeof(header)
+                               + header.vertexCount * sizeof(glm::vec3)
+                               + header.normalCount * sizeof(glm::vec3)
+                               + header.colorCount * sizeof(ofFloatColor)
+                               + header.texCoordCount * sizeof(glm::vec2)
+                               + header.indexCount * sizeof(ofIndexType);
+
+        if (size > record.size)
+            return view;
+
+        const uint8_t* payload = record.data + sizeof(header);
+        view.mode = ofPrimitiveMode(header.mode);
+        view.vertices = reinterpret_cast<const glm::vec3*>(payload);
+        view.vertexCount = header.vertexCount;
+        payload += header.vertexCount * sizeof(glm::vec3);
+        view.normals = reinterpret_cast<const glm::vec3*>(payload);
+        view.normalCount = header.normalCount;
+        payload += header.normalCount * sizeof(glm::vec3);
+        view.colors = reinterpret_cast<const ofFloatColor*>(payload);
+        view.colorCount = header.colorCount;
+        payload += header.colorCount * sizeof(ofFloatColor);
+        view.texCoords = reinterpret_cast<const glm::vec2*>(payload);
+        view.texCoordCount = header.texCoordCount;
+        payload += header.texCoordCount * sizeof(glm::vec2);
+        view.indices = reinterpret_cast<const ofIndexType*>(payload);
+        view.indexCount = header.indexCount;
+        return view;
+    }
+};
+
+
+/// \brief Reads records from a shared memory ring created by a SharedMemoryWriter.
+///
+/// Each reader consumes every record independently of other readers.
+class SharedMemoryReader: public SharedMemoryRing
+{
+public:
+    /// \brief The result of a read.
+    enum class Result
+    {
+        /// \brief A record was read and is valid.
+        OK,
+        /// \brief No new record is available.
+        EMPTY,
+        /// \brief The writer overwrote unread records. The reader skipped to
+        ///        the newest data and any decoded record must be discarded.
+        OVERRUN,
+        /// \brief A record was read intact but could not be decoded. The
+        ///        reader moved past it.
+        INVALID
+    };
+
+    /// \brief Open an existing shared memory ring.
+    /// \param name The POSIX shared memory name used by the writer.
+    /// \throws std::runtime_error if the ring cannot be opened.
+    SharedMemoryReader(const std::string& name)
+    {
+        _name = name;
+
+        int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+
+        if (fd < 0)
+            throw std::runtime_error("Unable to open shared memory " + name);
+
+        struct stat info;
+
+        if (::fstat(fd, &info) != 0 || std::size_t(info.st_size) < HEADER_SIZE)
+        {
+            ::close(fd);
+            throw std::runtime_error("Invalid shared memory " + name);
+        }
+
+        _map(fd, std::size_t(info.st_size));
+
+        if (_header->magic != MAGIC || _header->version != VERSION)
+            throw std::runtime_error("Invalid shared memory " + name);
+
+        // Start with the next published record.
+        _position = _header->writePosition.load(std::memory_order_acquire);
+    }
+
+    /// \brief Read the next record in place.
+    ///
+    /// \p callback is called with a SharedMemoryRecord whose payload points
+    /// into the ring. If the writer overwrites the record while the callback
+    /// runs, OVERRUN is returned and anything decoded must be discarded.
+    ///
+    /// \param callback Called with the record.
+    /// \returns the read result.
+    template<typename Callback>
+    Result read(Callback&& callback)
+    {
+        const uint64_t capacity = _header->capacity;
+
+        while (true)
+        {
+            const uint64_t writePosition = _header->writePosition.load(std::memory_order_acquire);
+
+            if (_position == writePosition)
+                return Result::EMPTY;
+
+            if (writePosition - _position > capacity)
+            {
+                _position = writePosition;
+                return Result::OVERRUN;
+            }
+
+            const uint64_t offset = _position % capacity;
+
+            RecordHeader header;
+            std::memcpy(&header, _data + offset, sizeof(header));
+
+            if (header.position != _position || !_valid(_position))
+            {
+                _position = writePosition;
+                return Result::OVERRUN;
+            }
+
+            if (header.type == PADDING)
+            {
+                _position += capacity - offset;
+                continue;
+            }
+
+            SharedMemoryRecord record;
+            record.type = header.type;
+            record.data = _data + offset + sizeof(RecordHeader);
+            record.size = header.size;
+
+            callback(record);
+
+            if (!_valid(_position))
+            {
+                _position = _header->writePosition.load(std::memory_order_acquire);
+                return Result::OVERRUN;
+            }
+
+            _position += recordSize(header.size);
+            return Result::OK;
+        }
+    }
+
+    /// \brief Read the next record as a document.
+    /// \param j The document, valid only if OK is returned.
+    /// \returns the read result, or INVALID if the record is not valid CBOR.
+    ///          Records that are not documents are skipped.
+    Result readDocument(nlohmann::json& j)
+    {
+        while (true)
+        {
+            bool isDocument = false;
+
+            Result result = read([&](const SharedMemoryRecord& record)
+            {
+                if (record.type != DOCUMENT)
+                    return;
+
+                isDocument = true;
+
+                // Decode straight from the ring. A torn record fails to parse
+                // or is caught by the overrun check after the callback.
+                j = nlohmann::json::from_cbor(record.data, record.data + record.size, true, false);
+            });
+
+            if (result != Result::OK || isDocument)
+                return (result == Result::OK && j.is_discarded()) ? Result::INVALID : result;
+        }
+    }
+
+    /// \brief Wait until a record may be available.
+    /// \param timeout The maximum time to wait.
+    /// \returns true if a record is available.
+    bool wait(std::chrono::microseconds timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        while (_position == _header->writePosition.load(std::memory_order_acquire))
+        {
+            const auto now = std::chrono::steady_clock::now();
+
+            if (now >= deadline)
+                return false;
+
+            _header->waiters.fetch_add(1);
+            const uint32_t sequence = _header->sequence.load();
+
+            if (_position == _header->writePosition.load(std::memory_order_acquire))
+                _wait(_header->sequence, sequence, std::chrono::duration_cast<std::chrono::microseconds>(deadline - now));
+
+            _header->waiters.fetch_sub(1);
+        }
+
+        return true;
+    }
+
+private:
+    /// \returns true if the record at \p position has not been overwritten.
+    bool _valid(uint64_t position) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return _header->reservePosition.load(std::memory_order_relaxed) - position <= _header->capacity;
+    }
+
+    /// \brief The position of the next record to read.
+    uint64_t _position = 0;
+
+};
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // !defined(TARGET_WIN32)
+
+
+#endif // OF_SERIALIZER_SHARED_MEMORY_H
@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_SOUND_BASE_TYPES_H
+#define OF_SERIALIZER_SOUND_BASE_TYPES_H
+
+
+#include "json.hpp"
+#include "ofSoundBaseTypes.h"
+
+
+NLOHMANN_JSON_SERIALIZE_ENUM( ofSoundDevice::Api, {
+    { ofSoundDevice::Api::UNSPECIFIED, "UNSPECIFIED" },
+    { ofSoundDevice::Api::DEFAULT, "DEFAULT" },
+    { ofSoundDevice::Api::ALSA, "ALSA" },
+    { ofSoundDevice::Api::PULSE, "PULSE" },
+    { ofSoundDevice::Api::OSS, "OSS" },
+    { ofSoundDevice::Api::JACK, "JACK" },
+    { ofSoundDevice::Api::OSX_CORE, "OSX_CORE" },
+    { ofSoundDevice::Api::MS_WASAPI, "MS_WASAPI" },
+    { ofSoundDevice::Api::MS_ASIO, "MS_ASIO" },
+    { ofSoundDevice::Api::MS_DS, "MS_DS" }
+})
+
+
+inline void to_json(nlohmann::json& j, const ofSoundDevice& v)
+{
+    j["name"] = v.name;
+    j["device_id"] = v.deviceID;
+    j["api"] = v.api;
+    j["input_channels"] = v.inputChannels;
+    j["output_channels"] = v.outputChannels;
+    j["is_default_input"] = v.isDefaultInput;
+    j["is_default_output"] = v.isDefaultOutput;
+    j["sample_rates"] = v.sampleRates;
+}
+
+
+inline void from_json(const nlohmann::json& j, ofSoundDevice& v)
+{
+    v.name = j.value("name", v.name);
+    v.deviceID = j.value("device_id", v.deviceID);
+    v.api = j.value("api", v.api);
+    v.inputChannels = j.value("input_channels", v.inputChannels);
+    v.outputChannels = j.value("output_channels", v.outputChannels);
+    v.isDefaultInput = j.value("is_default_input", v.isDefaultInput);
+    v.isDefaultOutput = j.value("is_default_output", v.isDefaultOutput);
+    v.sampleRates = j.value("sample_rates", v.sampleRates);
+}
+
+
+inline void to_json(nlohmann::json& j, const ofSoundStreamSettings& v)
+{
+    j["sample_rate"] = v.sampleRate;
+    j["buffer_size"] = v.bufferSize;
+    j["num_buffers"] = v.numBuffers;
+    j["num_input_channels"] = v.numInputChannels;
+    j["num_output_channels"] = v.numOutputChannels;
+    j["api"] = v.getApi();
+
+    if (v.getInDevice())
+        j["in_device"] = *v.getInDevice();
+
+    if (v.getOutDevice())
+        j["out_device"] = *v.getOutDevice();
+}
+
+
+inline void from_json(const nlohmann::json& j, ofSoundStreamSettings& v)
+{
+    v.sampleRate = j.value("sample_rate", v.sampleRate);
+    v.bufferSize = j.value("buffer_size", v.bufferSize);
+    v.numBuffers = j.value("num_buffers", v.numBuffers);
+    v.numInputChannels = j.value("num_input_channels", v.numInputChannels);
+    v.numOutputChannels = j.value("num_output_channels", v.numOutputChannels);
+
+    auto iter = j.find("api");
+    if (iter != j.end())
+        v.setApi(iter->get<ofSoundDevice::Api>());
+
+    iter = j.find("in_device");
+    if (iter != j.end())
+        v.setInDevice(iter->get<ofSoundDevice>());
+
+    iter = j.find("out_device");
+    if (iter != j.end())
+        v.setOutDevice(iter->get<ofSoundDevice>());
+}
+
+
+#endif // OF_SERIALIZER_SOUND_BASE_TYPES_H
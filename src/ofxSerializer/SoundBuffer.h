@@ -0,0 +1,410 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_SOUND_BUFFER_H
+#define OF_SERIALIZER_SOUND_BUFFER_H
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "json.hpp"
+#include "ofxSerializer/BoundedQueue.h"
+#include "ofxSerializer/SoundBaseTypes.h"
+#include "ofSoundBuffer.h"
+#include "ofFileUtils.h"
+#include "ofLog.h"
+
+
+/// \brief Serialize an ofSoundBuffer with its interleaved samples as a binary value.
+inline void to_json(nlohmann::json& j, const ofSoundBuffer& v)
+{
+    const auto& samples = v.getBuffer();
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(samples.data());
+
+    j["sample_rate"] = v.getSampleRate();
+    j["channels"] = v.getNumChannels();
+    j["tick_count"] = v.getTickCount();
+    j["device_id"] = v.getDeviceID();
+    j["samples"] = nlohmann::json::binary(std::vector<uint8_t>(bytes, bytes + samples.size() * sizeof(float)));
+}
+
+
+/// \brief Deserialize an ofSoundBuffer.
+///
+/// Samples may be a binary value of 32-bit floats or an array of numbers.
+inline void from_json(const nlohmann::json& j, ofSoundBuffer& v)
+{
+    const std::size_t channels = j.at("channels");
+    const nlohmann::json& samples = j.at("samples");
+
+    if (channels == 0)
+        throw std::invalid_argument("An ofSoundBuffer must have at least one channel.");
+
+    if (samples.is_binary())
+    {
+        const auto& bytes = samples.get_binary();
+        v.allocate(bytes.size() / sizeof(float) / channels, channels);
+        std::memcpy(v.getBuffer().data(), bytes.data(), v.size() * sizeof(float));
+    }
+    else
+    {
+        v.allocate(samples.size() / channels, channels);
+        for (std::size_t i = 0; i < v.size(); ++i)
+            v[i] = samples[i];
+    }
+
+    v.setSampleRate(j.value("sample_rate", v.getSampleRate()));
+    v.setTickCount(j.value("tick_count", v.getTickCount()));
+    v.setDeviceID(j.value("device_id", v.getDeviceID()));
+}
+
+
+namespace ofx {
+namespace Serializer {
+
+
+/// \brief The layout of a sound recording.
+///
+/// A recording starts with a FileHeader followed by a CBOR header document
+/// holding the stream settings and user metadata. It is followed by chunks,
+/// each a ChunkHeader followed by interleaved 32-bit float samples.
+struct SoundRecording
+{
+    struct FileHeader
+    {
+        char magic[4] = { 'o', 'f', 'S', 'B' };
+        uint32_t version = 1;
+
+        /// \brief The size of the CBOR header document.
+        uint32_t headerSize = 0;
+
+        uint32_t reserved = 0;
+
+        bool isValid() const
+        {
+            return std::memcmp(magic, "ofSB", 4) == 0 && version == 1;
+        }
+    };
+
+    struct ChunkHeader
+    {
+        uint32_t frames = 0;
+        uint32_t channels = 0;
+        uint32_t sampleRate = 0;
+        int32_t deviceID = 0;
+        uint64_t tickCount = 0;
+
+        /// \brief The offset of the chunk's first frame in the recorded buffer.
+        uint32_t frameOffset = 0;
+
+        uint32_t reserved = 0;
+    };
+};
+
+
+/// \brief Records sound buffers to a file from an audio callback.
+///
+/// Buffers are copied into preallocated chunks that are handed to a writer
+/// thread through lock-free queues. write() never allocates, locks or
+/// blocks, so it is safe to call from ofBaseSoundInput::audioIn(). If the
+/// writer falls behind, buffers are dropped and counted instead.
+class SoundBufferWriter
+{
+public:
+    /// \brief The writer settings.
+    struct Settings
+    {
+        /// \brief The recording path, relative to the data folder.
+        std::string filename = "recording.ofsb";
+
+        /// \brief The stream settings captured in the recording header.
+        ofSoundStreamSettings stream;
+
+        /// \brief Additional metadata captured in the recording header.
+        nlohmann::json metadata;
+
+        /// \brief The maximum number of interleaved samples per chunk.
+        ///        Larger buffers are split across chunks.
+        std::size_t chunkSamples = 8192;
+
+        /// \brief The number of preallocated chunks.
+        std::size_t chunkCount = 64;
+
+        /// \brief How often the writer thread drains the queue.
+        std::chrono::milliseconds flushInterval { 10 };
+    };
+
+    /// \brief Create a recording and start the writer thread.
+    /// \param settings The writer settings.
+    /// \throws std::runtime_error if the recording cannot be created.
+    SoundBufferWriter(const Settings& settings):
+        _settings(settings),
+        _free(settings.chunkCount),
+        _filled(settings.chunkCount)
+    {
+        const std::string path = ofToDataPath(settings.filename, true);
+        _stream.open(path, std::ios::binary | std::ios::trunc);
+
+        if (!_stream)
+            throw std::runtime_error("Unable to create " + path);
+
+        nlohmann::json header;
+        header["stream"] = settings.stream;
+        header["metadata"] = settings.metadata;
+
+        std::vector<uint8_t> bytes = nlohmann::json::to_cbor(header);
+
+        SoundRecording::FileHeader fileHeader;
+        fileHeader.headerSize = uint32_t(bytes.size());
+        _stream.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+        _stream.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+
+        _chunks.resize(settings.chunkCount);
+
+        for (auto& chunk: _chunks)
+        {
+            chunk.samples.reset(new float[settings.chunkSamples]);
+            Chunk* pointer = &chunk;
+            _free.tryPush(pointer);
+        }
+
+        _thread = std::thread(&SoundBufferWriter::_run, this);
+    }
+
+    /// \brief Write the remaining chunks and close the recording.
+    ~SoundBufferWriter()
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _running = false;
+        }
+
+        _condition.notify_all();
+        _thread.join();
+    }
+
+    /// \brief Queue a sound buffer for writing.
+    ///
+    /// This is safe to call from the audio thread.
+    ///
+    /// \param buffer The buffer to record.
+    /// \returns false if some of the buffer was dropped.
+    bool write(const ofSoundBuffer& buffer)
+    {
+        const std::size_t channels = buffer.getNumChannels();
+
+        if (channels == 0 || channels > _settings.chunkSamples)
+            return false;
+
+        const std::size_t framesPerChunk = _settings.chunkSamples / channels;
+        const std::size_t frames = buffer.getNumFrames();
+        const float* samples = buffer.getBuffer().data();
+
+        for (std::size_t frame = 0; frame < frames; frame += framesPerChunk)
+        {
+            Chunk* chunk = nullptr;
+
+            if (!_free.tryPop(chunk))
+            {
+                _dropped.fetch_add(frames - frame, std::memory_order_relaxed);
+                return false;
+            }
+
+            const std::size_t count = std::min(framesPerChunk, frames - frame);
+
+            chunk->header.frames = uint32_t(count);
+            chunk->header.channels = uint32_t(channels);
+            chunk->header.sampleRate = uint32_t(buffer.getSampleRate());
+            chunk->header.deviceID = int32_t(buffer.getDeviceID());
+            chunk->header.tickCount = buffer.getTickCount();
+            chunk->header.frameOffset = uint32_t(frame);
+            std::memcpy(chunk->samples.get(), samples + frame * channels, count * channels * sizeof(float));
+
+            // The filled queue holds every chunk, so this never fails.
+            _filled.tryPush(chunk);
+        }
+
+        return true;
+    }
+
+    /// \returns the number of frames dropped because the writer fell behind.
+    uint64_t dropped() const
+    {
+        return _dropped.load();
+    }
+
+private:
+    struct Chunk
+    {
+        SoundRecording::ChunkHeader header;
+        std::unique_ptr<float[]> samples;
+    };
+
+    void _run()
+    {
+        Chunk* chunk = nullptr;
+        uint64_t reportedDropped = 0;
+
+        while (true)
+        {
+            bool running = _running.load();
+
+            while (_filled.tryPop(chunk))
+            {
+                _stream.write(reinterpret_cast<const char*>(&chunk->header), sizeof(chunk->header));
+                _stream.write(reinterpret_cast<const char*>(chunk->samples.get()),
+                              std::streamsize(chunk->header.frames * chunk->header.channels * sizeof(float)));
+                _free.tryPush(chunk);
+            }
+
+            uint64_t dropped = _dropped.load(std::memory_order_relaxed);
+
+            if (dropped != reportedDropped)
+            {
+                ofLogWarning("SoundBufferWriter") << (dropped - reportedDropped) << " frames dropped.";
+                reportedDropped = dropped;
+            }
+
+            if (!running)
+                break;
+
+            // The audio thread never signals, so the writer polls.
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait_for(lock, _settings.flushInterval);
+        }
+
+        _stream.close();
+    }
+
+    /// \brief The writer settings.
+    Settings _settings;
+
+    /// \brief The preallocated chunks.
+    std::vector<Chunk> _chunks;
+
+    /// \brief Chunks available to the audio thread.
+    BoundedQueue<Chunk*> _free;
+
+    /// \brief Chunks waiting to be written.
+    BoundedQueue<Chunk*> _filled;
+
+    /// \brief The number of dropped frames.
+    std::atomic<uint64_t> _dropped { 0 };
+
+    /// \brief True until the writer is destroyed.
+    std::atomic<bool> _running { true };
+
+    /// \brief The recording. Only touched by the writer thread after construction.
+    std::ofstream _stream;
+
+    /// \brief Used only to wake the writer thread on destruction.
+    std::mutex _mutex;
+    std::condition_variable _condition;
+
+    std::thread _thread;
+
+};
+
+
+/// \brief Reads the chunks of a recording written by SoundBufferWriter.
+class SoundBufferReader
+{
+public:
+    /// \brief Open a recording.
+    /// \param filename The recording path, relative to the data folder.
+    /// \throws std::runtime_error if the recording cannot be read.
+    SoundBufferReader(const std::string& filename)
+    {
+        const std::string path = ofToDataPath(filename, true);
+        _stream.open(path, std::ios::binary);
+
+        SoundRecording::FileHeader fileHeader;
+
+        if (!_stream.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader)) || !fileHeader.isValid())
+            throw std::runtime_error("Invalid sound recording " + path);
+
+        std::vector<uint8_t> bytes(fileHeader.headerSize);
+
+        if (!_stream.read(reinterpret_cast<char*>(bytes.data()), std::streamsize(bytes.size())))
+            throw std::runtime_error("Invalid sound recording " + path);
+
+        _header = nlohmann::json::from_cbor(bytes);
+        _firstChunk = _stream.tellg();
+    }
+
+    /// \returns the recording header with "stream" settings and "metadata".
+    const nlohmann::json& header() const
+    {
+        return _header;
+    }
+
+    /// \returns the stream settings the recording was made with.
+    ofSoundStreamSettings streamSettings() const
+    {
+        return _header.value("stream", nlohmann::json::object()).get<ofSoundStreamSettings>();
+    }
+
+    /// \brief Read the next chunk.
+    ///
+    /// The buffer is only reallocated when the chunk size changes, so reading
+    /// chunks of a constant size into the same buffer does not allocate.
+    ///
+    /// \param buffer The buffer to fill.
+    /// \returns false at the end of the recording.
+    bool read(ofSoundBuffer& buffer)
+    {
+        SoundRecording::ChunkHeader header;
+
+        if (!_stream.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.channels == 0)
+            return false;
+
+        if (buffer.getNumFrames() != header.frames || buffer.getNumChannels() != header.channels)
+            buffer.allocate(header.frames, header.channels);
+
+        buffer.setSampleRate(int(header.sampleRate));
+        buffer.setDeviceID(header.deviceID);
+        buffer.setTickCount(header.tickCount);
+
+        return bool(_stream.read(reinterpret_cast<char*>(buffer.getBuffer().data()),
+                                 std::streamsize(buffer.size() * sizeof(float))));
+    }
+
+    /// \brief Restart reading from the first chunk.
+    void rewind()
+    {
+        _stream.clear();
+        _stream.seekg(_firstChunk);
+    }
+
+private:
+    /// \brief The recording.
+    std::ifstream _stream;
+
+    /// \brief The recording header document.
+    nlohmann::json _header;
+
+    /// \brief The offset of the first chunk.
+    std::streampos _firstChunk;
+
+};
+
+
+} } // namespace ofx::Serializer
+
+
+#endif // OF_SERIALIZER_SOUND_BUFFER_H
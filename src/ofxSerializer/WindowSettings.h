@@ -0,0 +1,57 @@
+//
+// Copyright (c) 2017 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier: MIT
+//
+
+
+#ifndef OF_SERIALIZER_WINDOW_SETTINGS_H
+#define OF_SERIALIZER_WINDOW_SETTINGS_H
+
+
+#include "json.hpp"
+#include "ofxSerializer/Glm.h"
+#include "ofWindowSettings.h"
+
+
+NLOHMANN_JSON_SERIALIZE_ENUM( ofWindowMode, {
+    { OF_WINDOW, "OF_WINDOW" },
+    { OF_FULLSCREEN, "OF_FULLSCREEN"},
+    { OF_GAME_MODE, "OF_GAME_MODE"}
+})
+
+
+inline void to_json(nlohmann::json& j, const ofWindowSettings& v)
+{
+    if (v.isPositionSet())
+        j["position"] = v.getPosition();
+    if (v.isSizeSet())
+        j["size"] = { { "width", v.getWidth() }, { "height", v.getHeight() } };;
+
+    if (!v.title.empty())
+        j["title"] = v.title;
+
+    j["window_mode"] = v.windowMode;
+}
+
+
+inline void from_json(const nlohmann::json& j, ofWindowSettings& v)
+{
+    auto iter = j.cbegin();
+    while (iter != j.cend())
+    {
+        const auto& key = iter.key();
+        const auto& value = iter.value();
+
+        if (key == "position") v.setPosition(value);
+        else if (key == "size")
+            v.setSize(value.value("width", 100),
+                      value.value("height", 100));
+        else if (key == "title") v.title = value;
+        else if (key == "window_mode") v.windowMode = value;
+        ++iter;
+    }
+}
+
+
+#endif // OF_SERIALIZER_WINDOW_SETTINGS_H
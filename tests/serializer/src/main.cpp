@@ -9,6 +9,27 @@
 #include "ofAppNoWindow.h"
 #include "ofxUnitTests.h"
 #include "ofxSerializer.h"
+#include "ofxSerializer/AsyncFileLoggerChannel.h"
+#include "ofxSerializer/Buffer.h"
+#include "ofxSerializer/Document.h"
+#include "ofxSerializer/DocumentIndex.h"
+#include "ofxSerializer/GeometryTransform.h"
+#include "ofxSerializer/Node.h"
+#include "ofxSerializer/ParallelLoad.h"
+#include "ofxSerializer/Parameter.h"
+#include "ofxSerializer/Pixels.h"
+#include "ofxSerializer/ProgressivePolyline.h"
+#include "ofxSerializer/SerializationCache.h"
+#include "ofxSerializer/SettingsCache.h"
+#include "ofxSerializer/SettingsRegistry.h"
+#include "ofxSerializer/SharedMemory.h"
+#include "ofxSerializer/SoundBuffer.h"
+
+
+#if !defined(TARGET_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 
 #define test_enum_json(e) ofxTest(e == ofJson(e), "e");
@@ -68,6 +89,446 @@ class ofApp: public ofxUnitTestsApp
             ofxTestEq(r0.isClosed(), r1.isClosed(), "ofPolyline");
         }
         
+        {
+            std::vector<ofNode> r0(3);
+            r0[0].setPosition(1, 2, 3);
+            r0[1].setParent(r0[0]);
+            r0[1].setOrientation(glm::angleAxis(0.5f, glm::vec3(0, 1, 0)));
+            r0[2].setParent(r0[1]);
+            r0[2].setScale(2);
+
+            std::vector<ofNode> r1;
+            ofx::Serializer::NodeHierarchyFromJson(ofx::Serializer::NodeHierarchyToJson(r0), r1);
+            ofxTestEq(r1.size(), r0.size(), "NodeHierarchy size");
+            ofxTestEq(r1[2].getParent() == &r1[1], true, "NodeHierarchy parents");
+            ofxTestEq(r1[2].getGlobalPosition(), r0[2].getGlobalPosition(), "NodeHierarchy global position");
+
+            ofx::Serializer::NodeHierarchyFromJson(ofJson::parse(ofx::Serializer::NodeHierarchyToJson(r0).dump()), r1);
+            ofxTestEq(r1[2].getGlobalPosition(), r0[2].getGlobalPosition(), "NodeHierarchy JSON text");
+
+            ofx::Serializer::NodeHierarchyEncoding encoding;
+            encoding.halfPositions = true;
+            encoding.compressOrientations = true;
+
+            bool rejected = false;
+            try
+            {
+                ofx::Serializer::NodeHierarchyToJson(r0, encoding);
+            }
+            catch (const std::invalid_argument&)
+            {
+                rejected = true;
+            }
+            ofxTest(rejected, "NodeHierarchy compressed without binary");
+
+            encoding.binary = true;
+            ofJson compressed = ofx::Serializer::NodeHierarchyToJson(r0, encoding);
+            ofx::Serializer::NodeHierarchyFromJson(ofJson::from_cbor(ofJson::to_cbor(compressed)), r1);
+            ofxTest(glm::distance(r1[2].getGlobalPosition(), r0[2].getGlobalPosition()) < 0.01f, "NodeHierarchy compressed");
+        }
+
+        {
+            std::string small = "small";
+            std::string large(10000, 'x');
+            ofBuffer r0(small.data(), small.size());
+            ofBuffer r1(large.data(), large.size());
+
+            ofJson j;
+
+            {
+                ofx::Serializer::AttachmentWriter writer("attachments.bin", 4096);
+                j["small"] = writer.add(r0);
+                j["large"] = writer.add(r1);
+            }
+
+            ofJson parsed = ofJson::parse(j.dump());
+            ofx::Serializer::AttachmentReader reader("attachments.bin");
+
+            ofBuffer small1;
+            ofBuffer large1;
+            reader.read(parsed["small"], small1);
+            reader.read(parsed["large"], large1);
+            ofxTestEq(parsed["small"]["base64"], ofJson("c21hbGw="), "AttachmentWriter::add() base64");
+            ofxTestEq(small1.getText(), small, "ofBuffer inline");
+            ofxTestEq(large1.getText(), large, "ofBuffer attachment");
+            ofxTestEq(reader.view(parsed["large"]).size, large.size(), "AttachmentReader::view()");
+
+            bool threw = false;
+
+            try
+            {
+                ofx::Serializer::AttachmentWriter writer("missing/attachments.bin", 4096);
+                writer.add(r1);
+            }
+            catch (const std::runtime_error&)
+            {
+                threw = true;
+            }
+
+            ofxTest(threw, "AttachmentWriter::add() write failure");
+
+            ofBuffer r2 = ofJson::from_cbor(ofJson::to_cbor(ofJson(r1))).get<ofBuffer>();
+            ofxTestEq(r2.getText(), large, "ofBuffer binary");
+        }
+
+        {
+            ofRectangle rectangle(1, 2, 3, 4);
+            glm::vec3 position(5, 6, 7);
+            ofJson document = { { "rectangle", rectangle }, { "nested", { { "position", position } } } };
+            ofSavePrettyJson("indexed.json", document);
+
+            ofx::Serializer::IndexedDocument r0("indexed.json", 2);
+            ofxTestEq(r0.get<ofRectangle>("/rectangle"), rectangle, "IndexedDocument::get()");
+            ofxTestEq(r0.get<glm::vec3>("/nested/position"), position, "IndexedDocument::get() nested");
+            // /rectangle and its 4 members, /nested and /nested/position.
+            ofxTestEq(r0.index().entries().size(), std::size_t(7), "DocumentIndex::entries()");
+        }
+
+        {
+            ofMesh r0 = ofMesh::sphere(10);
+            ofJson j = r0;
+
+            using namespace ofx::Serializer;
+
+            ofxTest(SaveDocument("mesh.json", j), "SaveDocument() uncompressed");
+            ofxTestEq(LoadDocument("mesh.json"), j, "LoadDocument() uncompressed");
+
+            ofxTest(SaveDocument("mesh.float.json", j, DocumentFormat::JSON_FLOAT), "SaveDocument() float");
+            ofMesh r1 = LoadDocument("mesh.float.json", DocumentFormat::JSON_FLOAT).get<ofMesh>();
+            ofxTest(r1.getVertices() == r0.getVertices(), "LoadDocument() float vertices");
+            ofxTest(r1.getNormals() == r0.getNormals(), "LoadDocument() float normals");
+            ofxTestEq(DumpJson(ofJson(0.1f)), std::string("0.1"), "DumpJson() float");
+            ofxTestEq(DumpJson(ofJson(0.1)), ofJson(0.1).dump(), "DumpJson() double");
+
+            if (IsCompressionSupported(Compression::ZLIB))
+            {
+                ofxTest(SaveDocument("mesh.json.gz", j, DocumentFormat::JSON, Compression::ZLIB), "SaveDocument() zlib");
+                ofxTestEq(LoadDocument("mesh.json.gz"), j, "LoadDocument() zlib");
+
+                CompressionSettings settings(Compression::ZLIB, 9);
+                settings.threads = 4;
+                settings.blockSize = 1 << 16;
+                ofxTest(SaveDocument("mesh.cbor.gz", j, DocumentFormat::CBOR, settings), "SaveDocument() zlib blocks");
+                ofxTestEq(LoadDocument("mesh.cbor.gz", DocumentFormat::CBOR), j, "LoadDocument() zlib blocks");
+            }
+
+            // Uncompressed documents that begin like a raw zlib header.
+            ofJson text = 80;
+            ofxTest(SaveDocument("number.json", text), "SaveDocument() number");
+            ofxTestEq(LoadDocument("number.json"), text, "LoadDocument() number");
+
+            ofJson map = { { "abcdefghijklmnopq", 0 } };
+            for (int i = 1; i < 8; ++i)
+                map["key" + ofToString(i)] = i;
+
+            ofxTest(SaveDocument("map.cbor", map, DocumentFormat::CBOR), "SaveDocument() CBOR map");
+            ofxTestEq(LoadDocument("map.cbor", DocumentFormat::CBOR), map, "LoadDocument() CBOR map");
+
+            // Documents that decompress to several times the buffer size.
+            ofJson large = ofJson::array();
+            for (int i = 0; i < 40000; ++i)
+                large.push_back(i);
+            large.push_back(std::string(300000, 'a'));
+
+            for (auto compression: { Compression::ZLIB, Compression::ZSTD })
+            {
+                if (!IsCompressionSupported(compression))
+                    continue;
+
+                ofxTest(SaveDocument("large.json", large, DocumentFormat::JSON, compression), "SaveDocument() large");
+                ofxTestEq(LoadDocument("large.json"), large, "LoadDocument() large");
+                ofxTestEq(LoadDocument("large.json", DocumentFormat::JSON, compression), large, "LoadDocument() large explicit");
+            }
+
+            // An uncompressed BSON document whose size begins like a gzip header.
+            ofJson bson = { { "s", std::string(0x088B1F - 13, 'x') } };
+            ofxTest(SaveDocument("gzip.bson", bson, DocumentFormat::BSON), "SaveDocument() BSON");
+            ofxTestEq(LoadDocument("gzip.bson", DocumentFormat::BSON), bson, "LoadDocument() BSON");
+        }
+
+        {
+            ofPolyline r0;
+
+            for (std::size_t i = 0; i < 1000; ++i)
+                r0.addVertex(glm::vec3(i, std::sin(i * 0.05f) * 20, 0));
+
+            ofJson j = ofJson::from_cbor(ofJson::to_cbor(ofx::Serializer::ProgressivePolylineToJson(r0)));
+
+            ofPolyline r1;
+            ofxTestEq(ofx::Serializer::ProgressivePolylineFromJson(j, r1), 0.0f, "ProgressivePolylineFromJson() full");
+            ofxTest(r1.getVertices() == r0.getVertices(), "ProgressivePolylineFromJson() lossless");
+
+            ofPolyline r2;
+            float tolerance = ofx::Serializer::ProgressivePolylineFromJson(j, r2, 1.0f);
+            ofxTest(tolerance <= 1.0f, "ProgressivePolylineFromJson() tolerance");
+            ofxTest(r2.size() < r0.size(), "ProgressivePolylineFromJson() simplified");
+            ofxTestEq(r2[0], r0[0], "ProgressivePolylineFromJson() first vertex");
+            ofxTestEq(r2[r2.size() - 1], r0[r0.size() - 1], "ProgressivePolylineFromJson() last vertex");
+
+            ofPolyline r3;
+            for (std::size_t i = 0; i < 9; ++i)
+                r3.addVertex(glm::vec3(i, 0, 0));
+
+            ofJson collinear = ofx::Serializer::ProgressivePolylineToJson(r3);
+            ofxTest(collinear["layers"].size() > 1, "ProgressivePolylineToJson() collinear layers");
+            ofxTestEq(collinear["layers"][0]["count"], ofJson(2), "ProgressivePolylineToJson() collinear endpoints");
+
+            ofPolyline r4;
+            ofx::Serializer::ProgressivePolylineFromJson(collinear, r4);
+            ofxTest(r4.getVertices() == r3.getVertices(), "ProgressivePolylineFromJson() collinear lossless");
+        }
+
+        {
+            ofMesh r0 = ofMesh::box(10, 20, 30);
+            ofJson j = r0;
+
+            ofx::Serializer::GeometryTransform transform;
+            transform.matrix = glm::translate(glm::vec3(100, 0, 0)) * glm::scale(glm::vec3(2));
+
+            ofMesh r1;
+            ofx::Serializer::GeometryBounds bounds = ofx::Serializer::TransformedMeshFromJson(j, r1, transform);
+            ofxTestEq(r1.getNumVertices(), r0.getNumVertices(), "TransformedMeshFromJson() vertices");
+            ofxTestEq(r1.getVertex(0), glm::vec3(transform.matrix * glm::vec4(r0.getVertex(0), 1)), "TransformedMeshFromJson() transform");
+            ofxTestEq(bounds.min, glm::vec3(90, -20, -30), "TransformedMeshFromJson() bounds min");
+            ofxTestEq(bounds.max, glm::vec3(110, 20, 30), "TransformedMeshFromJson() bounds max");
+            ofxTestEq(glm::length(r1.getNormal(0)), 1.0f, "TransformedMeshFromJson() normals");
+
+            ofPolyline r2;
+            r2.addVertex(glm::vec3(1, 2, 3));
+            r2.addVertex(glm::vec3(-1, 0, 0));
+
+            ofPolyline r3;
+            bounds = ofx::Serializer::TransformedPolylineFromJson(ofJson(r2), r3, transform);
+            ofxTestEq(r3[0], glm::vec3(102, 4, 6), "TransformedPolylineFromJson()");
+            ofxTestEq(bounds.min, glm::vec3(98, 0, 0), "TransformedPolylineFromJson() bounds");
+        }
+
+        {
+            ofFloatPixels r0;
+            r0.allocate(64, 48, OF_PIXELS_GRAY);
+
+            for (std::size_t i = 0; i < r0.size(); ++i)
+                r0[i] = 2.0f + std::sin(i * 0.01f);
+
+            ofx::Serializer::PixelsEncoding encoding;
+            encoding.rowsPerBand = 16;
+            encoding.threads = 4;
+
+            ofFloatPixels r1;
+            ofx::Serializer::CompressedPixelsFromJson(ofJson::from_cbor(ofJson::to_cbor(ofx::Serializer::CompressedPixelsToJson(r0, encoding))), r1);
+            ofxTest(std::memcmp(r0.getData(), r1.getData(), r0.getTotalBytes()) == 0, "CompressedPixelsFromJson() float");
+
+            ofShortPixels r2;
+            r2.allocate(64, 48, OF_PIXELS_RGB);
+
+            for (std::size_t i = 0; i < r2.size(); ++i)
+                r2[i] = uint16_t(i * 7);
+
+            ofShortPixels r3;
+            ofx::Serializer::CompressedPixelsFromJson(ofx::Serializer::CompressedPixelsToJson(r2, encoding), r3);
+            ofxTestEq(r3.getPixelFormat(), r2.getPixelFormat(), "CompressedPixelsFromJson() pixel format");
+            ofxTest(std::memcmp(r2.getData(), r3.getData(), r2.getTotalBytes()) == 0, "CompressedPixelsFromJson() short");
+
+            // Bands read back from JSON text are not binary.
+            bool threw = false;
+
+            try
+            {
+                ofx::Serializer::CompressedPixelsFromJson(ofJson::parse(ofx::Serializer::CompressedPixelsToJson(r2, encoding).dump()), r3, 4);
+            }
+            catch (const std::invalid_argument&)
+            {
+                threw = true;
+            }
+
+            ofxTest(threw, "CompressedPixelsFromJson() non-binary bands");
+        }
+
+        {
+            ofSoundBuffer r0;
+            r0.allocate(256, 2);
+            r0.setTickCount(12);
+
+            for (std::size_t i = 0; i < r0.size(); ++i)
+                r0[i] = std::sin(i * 0.01f);
+
+            ofSoundBuffer r1 = ofJson::from_cbor(ofJson::to_cbor(ofJson(r0))).get<ofSoundBuffer>();
+            ofxTest(r1.getBuffer() == r0.getBuffer(), "ofSoundBuffer samples");
+            ofxTestEq(r1.getTickCount(), r0.getTickCount(), "ofSoundBuffer::getTickCount()");
+
+            {
+                ofx::Serializer::SoundBufferWriter::Settings settings;
+                settings.filename = "recording.ofsb";
+                settings.stream.numInputChannels = 2;
+                settings.metadata = { { "session", "test" } };
+
+                ofx::Serializer::SoundBufferWriter writer(settings);
+                ofxTest(writer.write(r0), "SoundBufferWriter::write()");
+                ofxTest(writer.write(r0), "SoundBufferWriter::write()");
+            }
+
+            ofx::Serializer::SoundBufferReader reader("recording.ofsb");
+            ofxTestEq(reader.streamSettings().numInputChannels, std::size_t(2), "SoundBufferReader::streamSettings()");
+            ofxTestEq(reader.header()["metadata"]["session"], ofJson("test"), "SoundBufferReader::header()");
+
+            ofSoundBuffer r2;
+            std::size_t chunks = 0;
+
+            while (reader.read(r2))
+            {
+                ofxTest(r2.getBuffer() == r0.getBuffer(), "SoundBufferReader::read()");
+                ++chunks;
+            }
+
+            ofxTestEq(chunks, std::size_t(2), "SoundBufferReader chunks");
+        }
+
+        {
+            ofJson settings = { { "window", { { "position", glm::vec2(10, 20) }, { "title", "cached" } } } };
+            ofSavePrettyJson("cached.json", settings);
+            ofFile::removeFile("cached.json.cbor");
+
+            ofxTestEq(ofx::Serializer::LoadCachedJson("cached.json"), settings, "LoadCachedJson() parsed");
+            ofxTest(ofFile::doesFileExist("cached.json.cbor"), "LoadCachedJson() cache written");
+            ofxTestEq(ofx::Serializer::LoadCachedJson("cached.json"), settings, "LoadCachedJson() cached");
+
+            settings["window"]["title"] = "changed";
+            ofSavePrettyJson("cached.json", settings);
+            ofxTestEq(ofx::Serializer::LoadCachedJson("cached.json"), settings, "LoadCachedJson() stale");
+        }
+
+        {
+            ofJson document = ofJson::array();
+
+            for (int i = 0; i < 32; ++i)
+                document.push_back(ofPolyline::fromRectangle(ofRectangle(0, 0, i + 1, i + 1)));
+
+            document[7] = "invalid";
+
+            auto r0 = ofx::Serializer::ParallelLoad<ofPolyline>(document, 4);
+            ofxTestEq(r0.size(), document.size(), "ParallelLoad() size");
+            ofxTest(!r0[7].ok(), "ParallelLoad() error isolation");
+            ofxTest(r0[8].ok(), "ParallelLoad() after error");
+            ofxTestEq(r0[8].value.getBoundingBox().getWidth(), 9.0f, "ParallelLoad() order");
+            ofxTestEq(r0[8].pointer, std::string("/8"), "ParallelLoad() pointer");
+        }
+
+        {
+            ofx::Serializer::SerializationCache cache;
+            ofMesh r0 = ofMesh::sphere(10);
+
+            auto bytes0 = cache.encode(r0);
+            auto bytes1 = cache.encode(r0);
+            ofxTest(bytes0 == bytes1, "SerializationCache::encode() unchanged");
+            ofxTestEq(cache.hits(), uint64_t(1), "SerializationCache::hits()");
+            ofxTest(!cache.changed(r0), "SerializationCache::changed() unchanged");
+
+            r0.addVertex(glm::vec3(1, 2, 3));
+            ofxTest(cache.changed(r0), "SerializationCache::changed()");
+            ofxTestEq(ofJson::from_cbor(*cache.encode(r0)), ofJson(r0), "SerializationCache::encode() changed");
+
+            ofParameter<float> gain { "gain", 1 };
+            ofParameterGroup r1 { "settings", gain };
+
+            cache.encode(r1);
+            gain.set(1.0000001f);
+            ofxTest(cache.changed(r1), "SerializationCache::changed() exact parameter values");
+            ofxTestEq(ofJson::from_cbor(*cache.encode(r1))["gain"], ofJson(1.0000001f), "SerializationCache::encode() parameter group");
+        }
+
+#if !defined(TARGET_WIN32)
+        {
+            using namespace ofx::Serializer;
+
+            SharedMemoryWriter writer("/ofxSerializerTest", 1 << 20);
+            SharedMemoryReader reader("/ofxSerializerTest");
+
+            ofMesh r0 = ofMesh::sphere(10);
+            ofJson j = { { "rectangle", ofRectangle(1, 2, 3, 4) } };
+
+            ofxTest(writer.writeMesh(r0), "SharedMemoryWriter::writeMesh()");
+            ofxTest(writer.writeDocument(j), "SharedMemoryWriter::writeDocument()");
+            ofxTest(reader.wait(std::chrono::milliseconds(100)), "SharedMemoryReader::wait()");
+
+            ofMesh r1;
+            auto result = reader.read([&](const SharedMemoryRecord& record)
+            {
+                SharedMemoryMeshView::fromRecord(record).copyTo(r1);
+            });
+
+            ofxTest(result == SharedMemoryReader::Result::OK, "SharedMemoryReader::read()");
+            ofxTestEq(ofJson(r1), ofJson(r0), "SharedMemoryMeshView");
+
+            ofJson j1;
+            ofxTest(reader.readDocument(j1) == SharedMemoryReader::Result::OK, "SharedMemoryReader::readDocument()");
+            ofxTestEq(j1, j, "SharedMemoryReader::readDocument()");
+            ofxTest(reader.readDocument(j1) == SharedMemoryReader::Result::EMPTY, "SharedMemoryReader::readDocument() empty");
+
+            std::vector<uint8_t> invalid = { 0xff };
+            ofxTest(writer.write(SharedMemoryRing::DOCUMENT, invalid.data(), invalid.size()), "SharedMemoryWriter::write()");
+            ofxTest(reader.readDocument(j1) == SharedMemoryReader::Result::INVALID, "SharedMemoryReader::readDocument() invalid");
+        }
+
+        {
+            using namespace ofx::Serializer;
+
+            // A reader in a child process consumes documents from a small
+            // ring while the parent writes them. The child exits with 0 if
+            // every document it read was intact and in order.
+            SharedMemoryWriter writer("/ofxSerializerForkTest", 1 << 16);
+
+            int ready[2];
+            ofxTest(::pipe(ready) == 0, "pipe()");
+
+            pid_t pid = ::fork();
+
+            if (pid == 0)
+            {
+                SharedMemoryReader reader("/ofxSerializerForkTest");
+
+                if (::write(ready[1], "r", 1) != 1)
+                    ::_exit(1);
+
+                int last = -1;
+                int documents = 0;
+                bool ok = true;
+
+                while (last < 1999 && reader.wait(std::chrono::seconds(2)))
+                {
+                    ofJson j;
+                    auto result = reader.readDocument(j);
+
+                    if (result == SharedMemoryReader::Result::OK)
+                    {
+                        int index = j.value("index", -1);
+                        ok = ok && index > last && j.value("payload", std::string()).size() == std::size_t(index % 300);
+                        last = index;
+                        ++documents;
+                    }
+                    else if (result == SharedMemoryReader::Result::INVALID)
+                    {
+                        ok = false;
+                    }
+                }
+
+                ::_exit(ok && documents > 0 ? 0 : 1);
+            }
+
+            char byte = 0;
+            ofxTest(pid > 0 && ::read(ready[0], &byte, 1) == 1, "fork() reader ready");
+
+            for (int i = 0; i < 2000; ++i)
+                writer.writeDocument({ { "index", i }, { "payload", std::string(std::size_t(i % 300), 'x') } });
+
+            int status = 0;
+            ::waitpid(pid, &status, 0);
+            ::close(ready[0]);
+            ::close(ready[1]);
+
+            ofxTest(WIFEXITED(status) && WEXITSTATUS(status) == 0, "SharedMemoryReader across processes");
+        }
+#endif
+
         {
             test_enum_json(OF_LOG_VERBOSE);
             test_enum_json(OF_LOG_NOTICE);
@@ -77,6 +538,116 @@ class ofApp: public ofxUnitTestsApp
             test_enum_json(OF_LOG_SILENT);
         }
 
+        {
+            using namespace ofx::Serializer;
+
+            ofJson settings = {
+                { "logger", {
+                    { "type", "async_file" },
+                    { "filename", "async.log" },
+                    { "append", false },
+                    { "max_queued_messages", 8 },
+                    { "flush_interval", 250 },
+                    { "rotation_size", 4096 },
+                    { "overflow", "block" }
+                } }
+            };
+
+            // Restore the console before testing, as test results are logged.
+            ApplyLoggingSettings(settings);
+            auto channel = std::dynamic_pointer_cast<AsyncFileLoggerChannel>(ofGetLoggerChannel());
+            ofLogToConsole();
+
+            ofxTest(channel != nullptr, "ApplyLoggingSettings() async_file");
+
+            if (channel)
+            {
+                ofxTestEq(channel->settings().filename, std::string("async.log"), "ApplyLoggingSettings() filename");
+                ofxTest(!channel->settings().append, "ApplyLoggingSettings() append");
+                ofxTestEq(channel->settings().maxQueuedMessages, std::size_t(8), "ApplyLoggingSettings() max_queued_messages");
+                ofxTest(channel->settings().flushInterval == std::chrono::milliseconds(250), "ApplyLoggingSettings() flush_interval");
+                ofxTestEq(channel->settings().rotationSize, uint64_t(4096), "ApplyLoggingSettings() rotation_size");
+                ofxTest(channel->settings().overflowPolicy == AsyncFileLoggerChannel::OverflowPolicy::BLOCK, "ApplyLoggingSettings() overflow");
+            }
+
+            channel.reset();
+
+            auto countLines = [](const std::string& filename, const std::string& text)
+            {
+                std::size_t count = 0;
+                for (const auto& line: ofSplitString(ofBufferFromFile(filename).getText(), "\n", true))
+                    if (line.find(text) != std::string::npos)
+                        ++count;
+                return count;
+            };
+
+            auto logFromThreads = [](AsyncFileLoggerChannel& channel)
+            {
+                std::vector<std::thread> threads;
+                for (int t = 0; t < 4; ++t)
+                {
+                    threads.emplace_back([&channel]()
+                    {
+                        for (int i = 0; i < 1000; ++i)
+                            channel.log(OF_LOG_NOTICE, "", "message " + ofToString(i));
+                    });
+                }
+
+                for (auto& thread: threads)
+                    thread.join();
+            };
+
+            AsyncFileLoggerChannel::Settings channelSettings;
+            channelSettings.filename = "async.log";
+            channelSettings.append = false;
+            channelSettings.flushInterval = std::chrono::hours(1);
+
+            {
+                AsyncFileLoggerChannel logger(channelSettings);
+                logger.log(OF_LOG_NOTICE, "test", "flushed");
+            }
+
+            ofxTestEq(countLines("async.log", "test: flushed"), std::size_t(1), "AsyncFileLoggerChannel flush on destruction");
+
+            channelSettings.maxQueuedMessages = 4;
+            uint64_t dropped = 0;
+
+            {
+                AsyncFileLoggerChannel logger(channelSettings);
+                logFromThreads(logger);
+                dropped = logger.dropped();
+            }
+
+            ofxTestEq(countLines("async.log", "message ") + dropped, uint64_t(4000), "AsyncFileLoggerChannel DROP");
+            ofxTestEq(countLines("async.log", "messages dropped") > 0, dropped > 0, "AsyncFileLoggerChannel DROP reported");
+
+            channelSettings.overflowPolicy = AsyncFileLoggerChannel::OverflowPolicy::BLOCK;
+
+            {
+                AsyncFileLoggerChannel logger(channelSettings);
+                logFromThreads(logger);
+                dropped = logger.dropped();
+            }
+
+            ofxTestEq(dropped, uint64_t(0), "AsyncFileLoggerChannel BLOCK dropped()");
+            ofxTestEq(countLines("async.log", "message "), std::size_t(4000), "AsyncFileLoggerChannel BLOCK");
+
+            // Each line is 21 bytes, so 3 fit in a file before it rotates.
+            channelSettings.filename = "rotated.log";
+            channelSettings.rotationSize = 64;
+            ofFile::removeFile("rotated.log.1");
+
+            {
+                AsyncFileLoggerChannel logger(channelSettings);
+                for (int i = 0; i < 10; ++i)
+                    logger.log(OF_LOG_NOTICE, "", "rotation " + ofToString(i));
+            }
+
+            ofxTestEq(countLines("rotated.log.1", "rotation "), std::size_t(3), "AsyncFileLoggerChannel rotation");
+            ofxTestEq(countLines("rotated.log", "rotation 9"), std::size_t(1), "AsyncFileLoggerChannel rotation current");
+            ofxTest(ofFile("rotated.log.1").getSize() <= 64, "AsyncFileLoggerChannel rotation_size");
+        }
+
         {
             test_enum_json(OF_WINDOW);
             test_enum_json(OF_FULLSCREEN);
@@ -94,6 +665,53 @@ class ofApp: public ofxUnitTestsApp
             ofxTestEq(r0.title, r1.title, "ofWindowMode::title");
             ofxTestEq(r0.windowMode, r1.windowMode, "ofWindowMode::windowMode");
         }
+
+        {
+            ofx::Serializer::SettingsRegistry registry(ofJson({ { "window", { { "position", { { "x", 10 }, { "y", 20 } } } } } }));
+            registry.addAccessor<glm::vec2>("/window/position");
+            ofxTestEq(registry.read()->get<glm::vec2>("/window/position") != nullptr, true, "SettingsRegistry::get()");
+            ofxTestEq(*registry.read()->get<glm::vec2>("/window/position"), glm::vec2(10, 20), "SettingsRegistry::get()");
+
+            registry.publish(ofJson({ { "window", { { "position", { { "x", 30 }, { "y", 40 } } } } } }));
+            ofxTestEq(*registry.read()->get<glm::vec2>("/window/position"), glm::vec2(30, 40), "SettingsRegistry::publish()");
+            ofxTestEq(registry.read()->get<glm::vec3>("/window/position") == nullptr, true, "SettingsRegistry::get() unregistered");
+        }
+
+        {
+            ofParameter<float> gain { "gain", 0.5, 0, 1 };
+            ofParameter<glm::vec3> position { "position", glm::vec3(1, 2, 3) };
+            ofParameter<ofFloatColor> color { "color", ofFloatColor(0.1, 0.2, 0.3, 0.4) };
+            ofParameter<std::string> label { "label", "label" };
+            ofParameterGroup nested { "nested", position, color, label };
+            ofParameterGroup r0 { "settings", gain, nested };
+
+            ofJson j = r0;
+
+            ofParameter<float> gain1 { "gain", 0 };
+            ofParameter<glm::vec3> position1 { "position", glm::vec3() };
+            ofParameter<ofFloatColor> color1 { "color", ofFloatColor() };
+            ofParameter<std::string> label1 { "label", "" };
+            ofParameterGroup nested1 { "nested", position1, color1, label1 };
+            ofParameterGroup r1 { "settings", gain1, nested1 };
+
+            from_json(j, r1);
+
+            ofxTestEq(gain.get(), gain1.get(), "ofParameter<float>");
+            ofxTestEq(position.get(), position1.get(), "ofParameter<glm::vec3>");
+            ofxTestEq(color.get(), color1.get(), "ofParameter<ofFloatColor>");
+            ofxTestEq(label.get(), label1.get(), "ofParameter<std::string>");
+
+            // Names are JSON pointer tokens, so ~ must be escaped.
+            ofParameter<float> scale { "scale~x", 1 };
+            ofParameterGroup r2 { "persisted", scale };
+
+            {
+                ofx::Serializer::ParameterPersister persister(r2, "parameters.json");
+                scale = 2;
+            }
+
+            ofxTestEq(ofLoadJson("parameters.json")["scale~x"], ofJson(2.0f), "ParameterPersister escaped name");
+        }
     }
 };
 